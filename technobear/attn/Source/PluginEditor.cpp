@@ -22,13 +22,20 @@ PluginEditor::PluginEditor(PluginProcessor &p)
         );
     }
 
+    addParamPage(
+        std::make_shared<pcontrol_type>(processor_.params_.snapslot, 1.0f, 1.0f),
+        std::make_shared<pcontrol_type>(processor_.params_.snapxfade, 100.0f, 10.0f),
+        nullptr,
+        nullptr
+    );
+
     addButtonPage(
         std::make_shared<bcontrol_type>(processor_.params_.slew, 24, Colours::lightskyblue),
         nullptr,
         nullptr,
         nullptr,
-        nullptr,
-        nullptr,
+        std::make_shared<bcontrol_type>(processor_.params_.snapstore, 24, Colours::orange, Colours::black, false),
+        std::make_shared<bcontrol_type>(processor_.params_.snaprecall, 24, Colours::orange, Colours::black, false),
         nullptr,
         nullptr
     );
@@ -12,10 +12,12 @@ PluginProcessor::PluginProcessor()
 PluginProcessor::PluginProcessor(
     const AudioProcessor::BusesProperties &ioLayouts,
     AudioProcessorValueTreeState::ParameterLayout layout)
-    : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
+    : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()),
+      snapshots_(snapshotParams(), params_.snapslot, params_.snapxfade) {
     init();
     for (int i = 0; i < MAX_SIG_OUT; i++) {
         lastParam_[i] = params_.attnparams_[i]->val.getValue();
+        snapValues_[i] = lastParam_[i];
     }
 }
 
@@ -35,7 +37,11 @@ PluginProcessor::AttnParam::AttnParam(AudioProcessorValueTreeState &apvt, String
 
 
 PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt) :
-    slew(*apvt.getParameter(ID::slew)) {
+    slew(*apvt.getParameter(ID::slew)),
+    snapslot(*apvt.getParameter(ID::snapslot)),
+    snapstore(*apvt.getParameter(ID::snapstore)),
+    snaprecall(*apvt.getParameter(ID::snaprecall)),
+    snapxfade(*apvt.getParameter(ID::snapxfade)) {
     for (unsigned i = 0; i < MAX_SIG_IN; i++) {
         attnparams_.push_back(std::make_unique<AttnParam>(apvt, ID::attn, i));
     }
@@ -58,6 +64,12 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     }
     params.add(std::move(sg));
 
+    // added after attn, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::snapslot, "Snap", 1.0f, float(MAX_SNAPSHOTS), 1.0f, 1.0f));
+    params.add(std::make_unique<ssp::BaseBoolParameter>(ID::snapstore, "Store", false));
+    params.add(std::make_unique<ssp::BaseBoolParameter>(ID::snaprecall, "Recall", false));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::snapxfade, "XFade ms", 0.0f, 5000.0f, 0.0f));
+
     return params;
 }
 
@@ -79,7 +91,9 @@ const String PluginProcessor::getInputBusName(int channelIndex) {
         "In M",
         "In N",
         "In O",
-        "In P"
+        "In P",
+        "Snap",
+        "Snap Trig"
     };
     if (channelIndex < I_MAX) { return inBusName[channelIndex]; }
     return "ZZIn-" + String(channelIndex);
@@ -117,16 +131,24 @@ void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPe
 }
 
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned sz = buffer.getNumSamples();
 
     bool slew = params_.slew.getValue() > 0.5f;
 
+    const float *snapCV = isInputEnabled(I_SNAP) ? buffer.getReadPointer(I_SNAP) : nullptr;
+    const float *snapTrig = isInputEnabled(I_SNAP_TRIG) ? buffer.getReadPointer(I_SNAP_TRIG) : nullptr;
+    if (!snapshots_.process(snapCV, snapTrig, sz, getSampleRate(), snapValues_)) {
+        for (int i = 0; i < MAX_SIG_OUT; i++) {
+            snapValues_[i] = params_.attnparams_[i]->val.getValue();
+        }
+    }
+
     for (int i = 0; i < O_MAX; i++) {
         if (!isOutputEnabled(O_SIG_A + i)) continue;
 
         bool in = isInputEnabled(I_SIG_A + i);
-        float attnP = params_.attnparams_[i]->val.getValue();
+        float attnP = snapValues_[i];
 
         for (int smp = 0; smp < sz; smp++) {
             auto &lP = lastParam_[i];
@@ -143,6 +165,38 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
 }
 
 
+std::vector<juce::RangedAudioParameter *> PluginProcessor::snapshotParams() {
+    std::vector<juce::RangedAudioParameter *> values;
+    for (int i = 0; i < MAX_SIG_OUT; i++) {
+        values.push_back(&params_.attnparams_[i]->val);
+    }
+    return values;
+}
+
+
+void PluginProcessor::audioProcessorParameterChanged(AudioProcessor *p, int parameterIndex, float newValue) {
+    BaseProcessor::audioProcessorParameterChanged(p, parameterIndex, newValue);
+    if (newValue < 0.5f) return;
+    if (parameterIndex == params_.snapstore.getParameterIndex()) {
+        snapshots_.requestStore();
+    } else if (parameterIndex == params_.snaprecall.getParameterIndex()) {
+        snapshots_.requestRecall();
+    }
+}
+
+
+void PluginProcessor::customToXml(juce::XmlElement *xml) {
+    BaseProcessor::customToXml(xml);
+    snapshots_.toXml(xml);
+}
+
+
+void PluginProcessor::customFromXml(juce::XmlElement *xml) {
+    BaseProcessor::customFromXml(xml);
+    snapshots_.fromXml(xml);
+}
+
+
 AudioProcessorEditor *PluginProcessor::createEditor() {
     return new ssp::EditorHost(this, new PluginEditor(*this));
 }
@@ -3,6 +3,7 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "ssp/BaseProcessor.h"
+#include "ssp/SnapshotBank.h"
 
 #include <atomic>
 #include <algorithm>
@@ -19,6 +20,11 @@ PARAMETER_ID (slew)
 PARAMETER_ID (attn)
 PARAMETER_ID (val)
 
+PARAMETER_ID (snapslot)
+PARAMETER_ID (snapstore)
+PARAMETER_ID (snaprecall)
+PARAMETER_ID (snapxfade)
+
 #undef PARAMETER_ID
 }
 
@@ -31,7 +37,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -56,6 +62,8 @@ public:
         I_SIG_N,
         I_SIG_O,
         I_SIG_P,
+        I_SNAP,
+        I_SNAP_TRIG,
         I_MAX
     };
     enum {
@@ -80,6 +88,7 @@ public:
 
     static constexpr unsigned MAX_SIG_IN = (I_SIG_P - I_SIG_A) + 1;
     static constexpr unsigned MAX_SIG_OUT = (O_SIG_P - O_SIG_A) + 1;
+    static constexpr unsigned MAX_SNAPSHOTS = 16;
 
     struct AttnParam {
         using Parameter = juce::RangedAudioParameter;
@@ -94,6 +103,11 @@ public:
         Parameter &slew;
 
         std::vector<std::unique_ptr<AttnParam>> attnparams_;
+
+        Parameter &snapslot;
+        Parameter &snapstore;
+        Parameter &snaprecall;
+        Parameter &snapxfade;
     } params_;
     
     static BusesProperties getBusesProperties() {
@@ -110,6 +124,10 @@ public:
 protected:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    void customFromXml(juce::XmlElement *) override;
+    void customToXml(juce::XmlElement *) override;
+    void audioProcessorParameterChanged(AudioProcessor *p, int parameterIndex, float newValue) override;
+
 private:
     bool isBusesLayoutSupported(const BusesLayout &layouts) const override {
         return true;
@@ -121,6 +139,11 @@ private:
 
     float lastParam_[MAX_SIG_OUT];
 
+    // snapshots of attn values
+    std::vector<juce::RangedAudioParameter *> snapshotParams();
+    ssp::Snapshots<MAX_SIG_OUT, MAX_SNAPSHOTS> snapshots_;
+    float snapValues_[MAX_SIG_OUT]; // values in use
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };
 
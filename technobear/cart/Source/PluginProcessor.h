@@ -53,7 +53,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -19,9 +19,21 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
     init();
-    granularProcessor_ = nullptr;
-    ibuf_ = obuf_ = nullptr;
-    block_mem_ = block_ccm_ = nullptr;
+    fadeOnStateLoad(O_LEFT);
+    fadeOnStateLoad(O_RIGHT);
+
+    // allocated here, rather than on the first block (audio thread)
+    granularProcessor_ = new clouds::GranularProcessor;
+    ibuf_ = new clouds::ShortFrame[IO_BUF_SZ];
+    obuf_ = new clouds::ShortFrame[IO_BUF_SZ];
+    block_mem_ = new uint8_t[BLOCK_MEM_SZ * 2];
+    block_ccm_ = new uint8_t[BLOCK_CCM_SZ * 2];
+    memset(block_mem_, 0, sizeof(uint8_t) * BLOCK_MEM_SZ * 2);
+    memset(block_ccm_, 0, sizeof(uint8_t) * BLOCK_CCM_SZ * 2);
+    memset(granularProcessor_->mutable_parameters(), 0, sizeof(clouds::Parameters));
+    granularProcessor_->Init(
+        block_mem_, BLOCK_MEM_SZ,
+        block_ccm_, BLOCK_CCM_SZ);
 }
 
 PluginProcessor::~PluginProcessor() {
@@ -108,24 +120,7 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 }
 
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
-
-    if (granularProcessor_ == nullptr) {
-        granularProcessor_ = new clouds::GranularProcessor;
-        auto &processor = *granularProcessor_;
-
-        ibuf_ = new clouds::ShortFrame[IO_BUF_SZ];
-        obuf_ = new clouds::ShortFrame[IO_BUF_SZ];
-        block_mem_ = new uint8_t[BLOCK_MEM_SZ * 2];
-        block_ccm_ = new uint8_t[BLOCK_CCM_SZ * 2];
-        memset(block_mem_, 0, sizeof(uint8_t) * BLOCK_MEM_SZ * 2);
-        memset(block_ccm_, 0, sizeof(uint8_t) * BLOCK_CCM_SZ * 2);
-        memset(processor.mutable_parameters(), 0, sizeof(clouds::Parameters));
-        processor.Init(
-            block_mem_, BLOCK_MEM_SZ,
-            block_ccm_, BLOCK_CCM_SZ);
-    }
-
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
 
     auto &processor = *granularProcessor_;
 
@@ -134,9 +129,6 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
     bool stereoIn = inputEnabled[I_RIGHT];
     bool stereoOut = outputEnabled[O_RIGHT];
 
-    inRms_[0].process(buffer, I_LEFT);
-    if (stereoIn) inRms_[1].process(buffer, I_RIGHT);
-
     // note: clouds is run at 32khz, we are running at 48khz!
     // Clouds usually has a blocks size of 16,(?)
     // SSP = 128 (@48k), so split up, so we read the control rate date every 16
@@ -227,8 +219,6 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
             }
         }
     }
-    outRms_[0].process(buffer, O_LEFT);
-    if (stereoOut) outRms_[1].process(buffer, O_RIGHT);
 
 }
 
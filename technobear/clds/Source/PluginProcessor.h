@@ -6,7 +6,6 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "ssp/BaseProcessor.h"
-#include "ssp/RmsTrack.h"
 
 #include <atomic>
 #include <algorithm>
@@ -39,7 +38,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -65,10 +64,10 @@ public:
     } params_;
 
     void getRMS(float &lIn, float &rIn, float &lOut, float &rOut) {
-        lIn = inRms_[0].lvl();
-        rIn = inRms_[1].lvl();
-        lOut = outRms_[0].lvl();
-        rOut = outRms_[1].lvl();
+        lIn = inputLevel(I_LEFT).peak;
+        rIn = inputLevel(I_RIGHT).peak;
+        lOut = outputLevel(O_LEFT).peak;
+        rOut = outputLevel(O_RIGHT).peak;
     }
 
     static BusesProperties getBusesProperties() {
@@ -130,9 +129,6 @@ private:
     uint8_t *block_mem_;
     uint8_t *block_ccm_;
 
-    ssp::RmsTrack inRms_[2];
-    ssp::RmsTrack outRms_[2];
-
     float noteInputTranspose_ = 0.0f;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
@@ -157,7 +157,7 @@ void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPe
     jassert(sampleRate_ != 0);
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     static constexpr float trigLevel = 0.5f;
     unsigned sz = buffer.getNumSamples();
 
@@ -73,6 +73,7 @@ public:
 
     void visibilityChanged(bool b) override {
         PluginEditorInterface::visibilityChanged(b);
+        if (editor_) editor_->sspVisible(b);
     }
 
     void renderToImage(unsigned char *buffer, int width, int height) override {
@@ -186,6 +187,7 @@ public:
 
     ~SSP_PluginInterface() {
         if (editor_) delete editor_;
+        if (processor_) processor_->stopStateLoader();
         if (processor_) delete processor_;
     }
 
@@ -227,7 +229,8 @@ public:
     }
 
     void setState(void *buffer, size_t size) override {
-        processor_->setStateInformation(buffer, size);
+        // decoded in background, switched at a block boundary
+        processor_->loadStateAsync(buffer, int(size));
     }
 
     void prepare(double sampleRate, int samplesPerBlock) override {
@@ -1,9 +1,13 @@
 #include "BaseProcessor.h"
+#include "RtCheck.h"
 
 #include <juce_core/juce_core.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 
 #include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ssp {
 
@@ -20,12 +24,31 @@ BaseProcessor::BaseProcessor(
     juce::AudioProcessorValueTreeState::ParameterLayout pl)
     : AudioProcessor(ioLayouts), apvts(*this, nullptr, "state", std::move(pl)) {
     addListener(this);
+
+    pendingSize_ = getParameters().size() + 1;
+    pendingParams_.reset(new std::atomic<float>[pendingSize_]);
+    for (unsigned i = 0; i < pendingSize_; i++) {
+        pendingParams_[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+    pendingQueue_.reset(new int[pendingSize_]);
+    stateValues_.reset(new float[pendingSize_]);
+    outParams_.reset(new std::atomic<float>[pendingSize_]);
+    notifyParams_.reset(new std::atomic<float>[pendingSize_]);
+    for (unsigned i = 0; i < pendingSize_; i++) {
+        outParams_[i] = std::numeric_limits<float>::quiet_NaN();
+        notifyParams_[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+    midiAutomationChanged();
 }
 
 BaseProcessor::~BaseProcessor() {
     if (midiInDevice_) {
         midiInDevice_->stop();
     }
+    stopStateLoader();
+    notifyTimer_.stopTimer();
+    dspLogTimer_.stopTimer();
+    midiOutTimer_.stopTimer();
     if (midiOutDevice_) {
         midiOutDevice_->stopBackgroundThread();
     }
@@ -33,7 +56,18 @@ BaseProcessor::~BaseProcessor() {
 }
 
 void BaseProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPerBlock) {
-    ;
+    dspLogFile_ = SystemStats::getEnvironmentVariable("SSP_DSP_LOG", "");
+    if (dspLogFile_.isNotEmpty() && !dspLogTimer_.isTimerRunning()) dspLogTimer_.startTimer(DSP_LOG_INTERVAL);
+    keepDenormals_ = SystemStats::getEnvironmentVariable("SSP_KEEP_DENORMALS", "").isNotEmpty();
+}
+
+void BaseProcessor::logDspLoad() {
+    auto s = dspLoad_.stats();
+    File(dspLogFile_).appendText(Time::getCurrentTime().toString(true, true) + " " + getName()
+                                 + " mean " + String(s.mean * 100.0f, 1)
+                                 + "% p99 " + String(s.p99 * 100.0f, 1)
+                                 + "% max " + String(s.max * 100.0f, 1)
+                                 + "% xruns " + String(s.xruns) + "\n");
 }
 
 void BaseProcessor::releaseResources() {
@@ -41,7 +75,10 @@ void BaseProcessor::releaseResources() {
         midiInDevice_->stop();
         midiOutDevice_ = nullptr;
     }
+    const ScopedLock lock(midiLock_);
+    midiOutOpen_.store(false);
     if (midiOutDevice_) {
+        midiOutTimer_.stopTimer();
         midiOutDevice_->stopBackgroundThread();
         midiOutDevice_ = nullptr;
     }
@@ -93,6 +130,7 @@ void BaseProcessor::midiFromXml(juce::XmlElement *xml) {
     midiChannel_ = xml->getIntAttribute(MIDI_TAG_CHANNEL, 0);
     noteInput_ = xml->getBoolAttribute(MIDI_TAG_NOTE_INPUT, false);
 
+    const ScopedLock lock(midiLock_);
     midiAutomation_.clear();
     auto amXml = xml->getChildByName("Automation");
     if (amXml) {
@@ -107,6 +145,7 @@ void BaseProcessor::midiFromXml(juce::XmlElement *xml) {
             }
         }
     }
+    midiAutomationChanged();
 }
 
 void BaseProcessor::midiToXml(juce::XmlElement *xml) {
@@ -115,6 +154,7 @@ void BaseProcessor::midiToXml(juce::XmlElement *xml) {
     xml->setAttribute(MIDI_TAG_CHANNEL, midiChannel_);
     xml->setAttribute(MIDI_TAG_NOTE_INPUT, noteInput_);
 
+    const ScopedLock lock(midiLock_);
     auto amXml = xml->createNewChildElement("Automation");
     for (auto &ap: midiAutomation_) {
         auto &a = ap.second;
@@ -170,26 +210,40 @@ static const char *TEST_XML_TAG = "TEST";
 static const char *CUSTOM_XML_TAG = "CUSTOM";
 
 
-void BaseProcessor::getStateInformation(MemoryBlock &destData) {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xmlVst = std::make_unique<XmlElement>(VST_XML_TAG);
+// binary state format
+// header : magic, version
+// parameters : count, then (id hash, value) for each , values are unnormalised (as in the xml state)
+// xml : size, then VST element (midi, custom, test) as copyXmlToBinary, without parameters
+// older (xml only) states are still read
+static constexpr uint32 STATE_MAGIC = 0x42505353; // SSPB
+static constexpr uint32 STATE_VERSION = 1;
 
-    // first save state tree
-    std::unique_ptr<juce::XmlElement> xmlState(state.createXml());
-
-    // clean this xml by removing SSP parameters (encoders and alike)
-    std::unique_ptr<XmlElement> cleanStateXml = std::make_unique<XmlElement>(xmlState->getTagName());
-    for (int i = 0; i < xmlState->getNumChildElements(); i++) {
-        XmlElement *p = xmlState->getChildElement(i);
-        XmlElement *ne = new XmlElement(*p);
-        cleanStateXml->addChildElement(ne);
+// FNV-1a, stable across builds (unlike String::hashCode)
+static uint32 paramIdHash(const String &id) {
+    uint32 h = 2166136261u;
+    for (auto p = id.toRawUTF8(); *p != 0; p++) {
+        h = (h ^ uint8(*p)) * 16777619u;
     }
+    return h;
+}
 
+void BaseProcessor::getStateInformation(MemoryBlock &destData) {
+    MemoryOutputStream os(destData, false);
+    os.writeInt(int(STATE_MAGIC));
+    os.writeInt(int(STATE_VERSION));
+
+    auto &params = getParameters();
+    os.writeInt(params.size());
+    for (auto p: params) {
+        auto rp = dynamic_cast<RangedAudioParameter *>(p);
+        os.writeInt(rp != nullptr ? int(paramIdHash(rp->getParameterID())) : 0);
+        os.writeFloat(rp != nullptr ? rp->convertFrom0to1(rp->getValue()) : p->getValue());
+    }
 
+    std::unique_ptr<juce::XmlElement> xmlVst = std::make_unique<XmlElement>(VST_XML_TAG);
     std::unique_ptr<juce::XmlElement> xmlMidi = std::make_unique<XmlElement>(MIDI_XML_TAG);
     std::unique_ptr<juce::XmlElement> xmlCustom = std::make_unique<XmlElement>(CUSTOM_XML_TAG);
 
-
     midiToXml(xmlMidi.get());
     customToXml(xmlCustom.get());
 #ifdef __APPLE__
@@ -198,29 +252,101 @@ void BaseProcessor::getStateInformation(MemoryBlock &destData) {
     if (xmlTest) xmlVst->addChildElement(xmlTest.release());
 #endif
 
-    if (xmlState) xmlVst->addChildElement(cleanStateXml.release());
     if (xmlMidi) xmlVst->addChildElement(xmlMidi.release());
     if (xmlCustom) xmlVst->addChildElement(xmlCustom.release());
-    copyXmlToBinary(*xmlVst, destData);
+
+    MemoryBlock xmlData;
+    copyXmlToBinary(*xmlVst, xmlData);
+    os.writeInt(int(xmlData.getSize()));
+    os.write(xmlData.getData(), xmlData.getSize());
+}
+
+
+void BaseProcessor::vstFromXml(juce::XmlElement *xml) {
+#ifdef __APPLE__
+    auto xmlTest = xml->getChildByName(TEST_XML_TAG);
+    if (xmlTest != nullptr) testFromXml(xmlTest);
+#endif
+    auto xmlMidi = xml->getChildByName(MIDI_XML_TAG);
+    if (xmlMidi != nullptr) midiFromXml(xmlMidi);
+
+    auto xmlCustom = xml->getChildByName(CUSTOM_XML_TAG);
+    if (xmlCustom != nullptr) customFromXml(xmlCustom);
+}
+
+
+bool BaseProcessor::decodeState(const void *data, int sizeInBytes, std::map<uint32, float> &values,
+                                std::unique_ptr<juce::XmlElement> &xml) {
+    MemoryInputStream is(data, size_t(sizeInBytes), false);
+    if (sizeInBytes < 12 || uint32(is.readInt()) != STATE_MAGIC) return false;
+    if (uint32(is.readInt()) > STATE_VERSION) return false;
+
+    int nValues = is.readInt();
+    if (nValues < 0 || int64(nValues) * 8 > is.getNumBytesRemaining()) return false;
+    for (int i = 0; i < nValues; i++) {
+        uint32 h = uint32(is.readInt());
+        values[h] = is.readFloat();
+    }
+
+    int xmlSize = is.readInt();
+    if (xmlSize > 0 && xmlSize <= is.getNumBytesRemaining()) {
+        MemoryBlock xmlData;
+        is.readIntoMemoryBlock(xmlData, xmlSize);
+        xml = getXmlFromBinary(xmlData.getData(), int(xmlData.getSize()));
+        if (xml != nullptr && !xml->hasTagName(VST_XML_TAG)) xml = nullptr;
+    }
+    return true;
+}
+
+
+void BaseProcessor::stateValues(const std::map<uint32, float> &values, float *normValues) {
+    // missing parameters return to default (as replaceState)
+    auto &params = getParameters();
+    for (int i = 0; i < params.size(); i++) {
+        auto rp = dynamic_cast<RangedAudioParameter *>(params[i]);
+        if (rp == nullptr) {
+            normValues[i] = params[i]->getValue();
+            continue;
+        }
+        auto vi = values.find(paramIdHash(rp->getParameterID()));
+        normValues[i] = vi != values.end() ? rp->convertTo0to1(vi->second) : rp->getDefaultValue();
+    }
+}
+
+
+void BaseProcessor::applyStateValues(const float *normValues) {
+    // only notify parameters that change
+    auto &params = getParameters();
+    for (int i = 0; i < params.size(); i++) {
+        if (normValues[i] != params[i]->getValue()) params[i]->setValueNotifyingHost(normValues[i]);
+    }
+}
+
+
+bool BaseProcessor::stateFromBinary(const void *data, int sizeInBytes) {
+    std::map<uint32, float> values;
+    std::unique_ptr<juce::XmlElement> xml;
+    if (!decodeState(data, sizeInBytes, values, xml)) return false;
+
+    if (xml != nullptr) vstFromXml(xml.get());
+
+    std::vector<float> normValues(size_t(getParameters().size()));
+    stateValues(values, normValues.data());
+    applyStateValues(normValues.data());
+    return true;
 }
 
 
 void BaseProcessor::setStateInformation(const void *data, int sizeInBytes) {
+    if (stateFromBinary(data, sizeInBytes)) return;
+
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml.get() != nullptr) {
         if (xml->hasTagName(apvts.state.getType())) {
             // backwards compat
             apvts.replaceState(juce::ValueTree::fromXml(*xml));
         } else if (xml->hasTagName(VST_XML_TAG)) {
-#ifdef __APPLE__
-            auto xmlTest = xml->getChildByName(TEST_XML_TAG);
-            if (xmlTest != nullptr) testFromXml(xmlTest);
-#endif
-            auto xmlMidi = xml->getChildByName(MIDI_XML_TAG);
-            if (xmlMidi != nullptr) midiFromXml(xmlMidi);
-
-            auto xmlCustom = xml->getChildByName(CUSTOM_XML_TAG);
-            if (xmlCustom != nullptr) customFromXml(xmlCustom);
+            vstFromXml(xml.get());
 
             auto xmlState = xml->getChildByName(apvts.state.getType()); //STATE
             if (xmlState != nullptr) apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
@@ -229,6 +355,151 @@ void BaseProcessor::setStateInformation(const void *data, int sizeInBytes) {
 }
 
 
+void BaseProcessor::loadStateAsync(const void *data, int sizeInBytes) {
+    // audio not running (nothing to fade, or to wait for), older xml state, or module loads synchronously
+    bool binary = sizeInBytes >= 12 && uint32(ByteOrder::littleEndianInt(data)) == STATE_MAGIC;
+    if (!binary || !asyncStateLoad()
+        || Time::getMillisecondCounter() - lastBlockMs_.load(std::memory_order_relaxed) > STATE_IDLE_MS) {
+        setStateInformation(data, sizeInBytes);
+        return;
+    }
+
+    // audio thread sets parameters, listeners are notified from here
+    if (!notifyTimer_.isTimerRunning()) notifyTimer_.startTimer(NOTIFY_INTERVAL);
+
+    {
+        const ScopedLock lock(stateLoadLock_);
+        stateLoadData_.replaceAll(data, size_t(sizeInBytes));
+        stateLoadPending_ = true;
+    }
+    if (!stateLoader_.isThreadRunning()) stateLoader_.startThread();
+    stateLoader_.notify();
+}
+
+
+void BaseProcessor::stopStateLoader() {
+    stateLoader_.signalThreadShouldExit();
+    stateLoader_.notify();
+    stateLoader_.stopThread(1000);
+}
+
+
+void BaseProcessor::StateLoader::run() {
+    while (!threadShouldExit()) {
+        MemoryBlock data;
+        {
+            const ScopedLock lock(processor_.stateLoadLock_);
+            if (processor_.stateLoadPending_) {
+                data.swapWith(processor_.stateLoadData_);
+                processor_.stateLoadPending_ = false;
+            }
+        }
+        if (data.getSize() > 0) {
+            processor_.loadState(data);
+        } else {
+            wait(-1);
+        }
+    }
+}
+
+
+void BaseProcessor::loadState(const MemoryBlock &data) {
+    std::map<uint32, float> values;
+    std::unique_ptr<juce::XmlElement> xml;
+    if (!decodeState(data.getData(), int(data.getSize()), values, xml)) return;
+
+    // wait for audio thread to commit previous state
+    while (stateReady_.load(std::memory_order_acquire)) {
+        if (stateLoader_.threadShouldExit()) return;
+        if (Time::getMillisecondCounter() - lastBlockMs_.load(std::memory_order_relaxed) > STATE_IDLE_MS) {
+            // audio stopped, nothing will commit
+            applyStateValues(stateValues_.get());
+            stateReady_.store(false, std::memory_order_release);
+            break;
+        }
+        Thread::sleep(1);
+    }
+
+    if (xml != nullptr) vstFromXml(xml.get());
+    stateValues(values, stateValues_.get());
+    stateReady_.store(true, std::memory_order_release);
+}
+
+
+void BaseProcessor::applyPendingState() {
+    lastBlockMs_.store(Time::getMillisecondCounter(), std::memory_order_relaxed);
+
+    switch (stateFade_) {
+        case FADE_NONE :
+            if (stateReady_.load(std::memory_order_acquire)) stateFade_ = FADE_OUT;
+            break;
+        case FADE_OUT : {
+            // previous block faded out, switch
+            auto &params = getParameters();
+            for (int i = 0; i < params.size(); i++) {
+                if (stateValues_[i] != params[i]->getValue()) setValueDeferNotify(i, stateValues_[i]);
+            }
+            stateReady_.store(false, std::memory_order_release);
+            stateFade_ = FADE_IN;
+            break;
+        }
+        case FADE_IN :
+        default:
+            stateFade_ = FADE_NONE;
+            break;
+    }
+}
+
+
+void BaseProcessor::fadePendingState(AudioSampleBuffer &buffer) {
+    if (stateFade_ == FADE_NONE || stateFadeMask_ == 0) return;
+    int n = buffer.getNumSamples();
+    float from = stateFade_ == FADE_OUT ? 1.0f : 0.0f;
+    for (int ch = 0; ch < std::min(buffer.getNumChannels(), int(numOut)); ch++) {
+        if (stateFadeMask_ & (1u << ch)) buffer.applyGainRamp(ch, 0, n, from, 1.0f - from);
+    }
+}
+
+
+void BaseProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+    // flush denormals to zero (FZ in FPSCR on arm, FTZ/DAZ in MXCSR on x86) for the block
+    // decaying feedback (delays, reverb, filters, envelopes) otherwise become very slow on arm vfp
+    ScopedNoDenormals noDenormals;
+    if (keepDenormals_) FloatVectorOperations::disableDenormalisedNumberSupport(false);
+    RtCheck::Scope rtCheck;
+    applyMidiAutomation();
+    dspLoad_.begin();
+    applyPendingState();
+    meterInputs(buffer);
+    processAudio(buffer, midiMessages);
+    fadePendingState(buffer);
+    meterOutputs(buffer);
+    dspLoad_.end(buffer.getNumSamples(), getSampleRate());
+}
+
+
+void BaseProcessor::meterInputs(const AudioSampleBuffer &buffer) {
+    meter(inMeters_, buffer, inputEnabled, numIn);
+}
+
+
+void BaseProcessor::meterOutputs(const AudioSampleBuffer &buffer) {
+    meter(outMeters_, buffer, outputEnabled, numOut);
+}
+
+
+void BaseProcessor::meter(Meters &meters, const AudioSampleBuffer &buffer, const bool *enabled, unsigned nCh) {
+    if (Time::getMillisecondCounter() - meterReadMs_.load(std::memory_order_relaxed) > METER_IDLE_MS) return;
+
+    const float *channels[Meters::MAX_CH];
+    nCh = std::min(nCh, unsigned(buffer.getNumChannels()));
+    for (unsigned c = 0; c < nCh; c++) {
+        channels[c] = enabled[c] ? buffer.getReadPointer(int(c)) : nullptr;
+    }
+    meters.process(channels, nCh, unsigned(buffer.getNumSamples()), float(getSampleRate()));
+}
+
+
 void BaseProcessor::onInputChanged(unsigned i, bool b) {
     if (i < numIn) inputEnabled[i] = b;
 }
@@ -277,6 +548,7 @@ void BaseProcessor::setMidiIn(const std::string &name) {
                 midiInDevice_ = MidiInput::openDevice(id, this);
                 if (midiInDevice_ && midiInDevice_->getIdentifier().toStdString() == id) {
                     midiInDevice_->start();
+                    if (!notifyTimer_.isTimerRunning()) notifyTimer_.startTimer(NOTIFY_INTERVAL);
                     // Logger::writeToLog(getName() + ": MIDI IN OPEN -> " + id);
                     midiInDeviceName_ = name;
                     return;
@@ -290,10 +562,13 @@ void BaseProcessor::setMidiIn(const std::string &name) {
 }
 
 void BaseProcessor::setMidiOut(const std::string &name) {
+    // called from the message and state loader threads, sendMidiAutomation uses the device on the message thread
+    const ScopedLock lock(midiLock_);
     if (name == midiOutDeviceName_) return;
 
     if (!name.empty()) {
         if (midiOutDevice_) {
+            midiOutTimer_.stopTimer();
             midiOutDevice_->stopBackgroundThread();
             midiOutDevice_ = nullptr;
         }
@@ -304,8 +579,10 @@ void BaseProcessor::setMidiOut(const std::string &name) {
                 midiOutDevice_ = MidiOutput::openDevice(id);
                 if (midiOutDevice_ && midiOutDevice_->getIdentifier().toStdString() == id) {
                     midiOutDevice_->startBackgroundThread();
+                    midiOutTimer_.startTimer(MIDI_OUT_INTERVAL);
                     // Logger::writeToLog(getName() + ": MIDI OUT OPEN -> " + id);
                     midiOutDeviceName_ = name;
+                    midiOutOpen_.store(true);
                     return;
                 }
             } else {
@@ -313,60 +590,193 @@ void BaseProcessor::setMidiOut(const std::string &name) {
             }
         }
     }
+    midiOutOpen_.store(false);
     midiOutDevice_ = nullptr;
 }
 
-void BaseProcessor::automateParam(int idx, const MidiAutomation &a, const MidiMessage &msg) {
-    auto &plist = getParameters();
-    if (idx < plist.size()) {
-        auto p = plist[idx];
-
-        float val = p->getValue();
-        if (msg.isController()) {
-            val = float(msg.getControllerValue()) / 127.0f;
-        } else if (msg.isNoteOn()) {
-            val = msg.getFloatVelocity();
-        } else if (msg.isNoteOff()) {
-            val = 0.0f;
+void BaseProcessor::MidiDispatch::build(const std::map<int, MidiAutomation> &automation) {
+    for (unsigned n = 0; n < MAX_NUM; n++) {
+        cc_[n] = -1;
+        note_[n] = -1;
+    }
+    pressure_ = -1;
+    for (unsigned n = 0; n < MAX_CC14; n++) {
+        cc14_[n] = -1;
+    }
+
+    int16_t nTargets = 0;
+    for (auto &ap: automation) {
+        auto &a = ap.second;
+        if (a.midi_.num_ < 0 || a.midi_.num_ >= int(MAX_NUM)) continue;
+
+        int16_t *head = nullptr;
+        switch (a.midi_.type_) {
+            case MidiAutomation::Midi::T_CC :
+                head = &cc_[a.midi_.num_];
+                break;
+            case MidiAutomation::Midi::T_NOTE :
+                head = &note_[a.midi_.num_];
+                break;
+            case MidiAutomation::Midi::T_PRESSURE :
+                head = &pressure_;
+                break;
+            case MidiAutomation::Midi::T_CC14 :
+                if (a.midi_.num_ < int(MAX_CC14)) head = &cc14_[a.midi_.num_];
+                break;
+            default:
+                break;
         }
+        if (head == nullptr || nTargets >= int16_t(MAX_TARGETS)) continue;
+
+        auto &t = targets_[nTargets];
+        t.paramIdx_ = a.paramIdx_;
+        t.scale_ = a.scale_;
+        t.offset_ = a.offset_;
+        t.next_ = *head;
+        *head = nTargets;
+        nTargets++;
+    }
+}
 
-        val = (val * a.scale_) + a.offset_;
+void BaseProcessor::midiAutomationChanged() {
+    const ScopedLock lock(midiLock_);
+    // build the table not in use, then switch to it
+    auto active = activeDispatch_.load();
+    auto next = active == &midiDispatch_[0] ? &midiDispatch_[1] : &midiDispatch_[0];
+    // the midi thread may still be walking it, if it was loaded before the last switch
+    while (dispatchReading_.load() == next) Thread::yield();
+    next->build(midiAutomation_);
+    activeDispatch_.store(next);
+}
+
+void BaseProcessor::removeMidiAutomation(int paramIdx) {
+    const ScopedLock lock(midiLock_);
+    midiAutomation_.erase(paramIdx);
+    midiAutomationChanged();
+}
 
-        if (p->getValue() != val) {
-            p->beginChangeGesture();
-            p->setValueNotifyingHost(val);
-            p->endChangeGesture();
+void BaseProcessor::queueParam(const MidiDispatch &dispatch, int16_t target, float val) {
+    for (; target >= 0; target = dispatch.targets_[target].next_) {
+        auto &t = dispatch.targets_[target];
+        if (t.paramIdx_ < 0 || t.paramIdx_ >= int(pendingSize_)) continue;
+
+        float v = (val * t.scale_) + t.offset_;
+        // only queue index if no value was already pending, later writes just replace the value
+        float prev = pendingParams_[t.paramIdx_].exchange(v, std::memory_order_acq_rel);
+        if (std::isnan(prev)) {
+            unsigned wr = pendingWr_.load(std::memory_order_relaxed);
+            pendingQueue_[wr % pendingSize_] = t.paramIdx_;
+            pendingWr_.store(wr + 1, std::memory_order_release);
         }
     }
 }
 
+void BaseProcessor::applyMidiAutomation() {
+    unsigned rd = pendingRd_.load(std::memory_order_relaxed);
+    unsigned wr = pendingWr_.load(std::memory_order_acquire);
+    if (rd == wr) return;
+
+    auto &plist = getParameters();
+    while (rd != wr) {
+        int idx = pendingQueue_[rd % pendingSize_];
+        float val = pendingParams_[idx].exchange(std::numeric_limits<float>::quiet_NaN(), std::memory_order_acq_rel);
+        // release slot per entry, so queue never holds more than one entry per parameter, plus this one
+        pendingRd_.store(++rd, std::memory_order_release);
+        if (std::isnan(val) || idx >= plist.size()) continue;
+
+        if (plist[idx]->getValue() != val) setValueDeferNotify(idx, val);
+    }
+}
+
+void BaseProcessor::setValueDeferNotify(int paramIdx, float val) {
+    // notifying takes listener locks and calls every listener, so leave it to the message thread
+    getParameters()[paramIdx]->setValue(val);
+    notifyParams_[paramIdx].store(val, std::memory_order_release);
+}
+
+void BaseProcessor::notifyParameters() {
+    auto &plist = getParameters();
+    for (int i = 0; i < plist.size(); i++) {
+        float v = notifyParams_[i].exchange(std::numeric_limits<float>::quiet_NaN(), std::memory_order_acq_rel);
+        if (std::isnan(v)) continue;
+        plist[i]->sendValueChangedMessageToListeners(plist[i]->getValue());
+    }
+}
+
+bool BaseProcessor::learnMidi(const MidiMessage &msg) {
+    if (learntIdx_ >= 0) {
+        // lsb following the msb just learnt, switch to 14 bit
+        auto ai = midiAutomation_.find(learntIdx_);
+        if (ai != midiAutomation_.end()) {
+            auto &m = ai->second.midi_;
+            if (m.type_ == MidiAutomation::Midi::T_CC && m.num_ < int(MidiDispatch::MAX_CC14)
+                && m.num_ + int(MidiDispatch::MAX_CC14) == msg.getControllerNumber()
+                && m.channel_ == msg.getChannel()) {
+                m.type_ = MidiAutomation::Midi::T_CC14;
+                learntIdx_ = -1;
+                lastLearn_.reset();
+                midiAutomationChanged();
+                return true;
+            }
+        }
+    }
+
+    if (lastLearn_.paramIdx_ >= 0) {
+        auto &m = lastLearn_.midi_;
+        m.type_ = MidiAutomation::Midi::T_CC;
+        m.num_ = msg.getControllerNumber();
+        m.channel_ = msg.getChannel();
+
+        midiAutomation_[lastLearn_.paramIdx_] = lastLearn_;
+        learntIdx_ = lastLearn_.paramIdx_;
+        lastLearn_.reset();
+        midiAutomationChanged();
+    }
+    return false;
+}
+
 void BaseProcessor::handleMidi(const MidiMessage &msg) {
     if (midiChannel_ == 0 || msg.getChannel() == midiChannel_) {
-        if (midiLearn_) {
-            if (lastLearn_.paramIdx_ >= 0) {
-                if (msg.isController()) {
-                    auto &m = lastLearn_.midi_;
-                    m.type_ = MidiAutomation::Midi::T_CC;
-                    m.num_ = msg.getControllerNumber();
-                    m.channel_ = msg.getChannel();
-
-                    midiAutomation_[lastLearn_.paramIdx_] = lastLearn_;
-                    lastLearn_.reset();
-                }
-            }
+        if (midiLearn_ && msg.isController()) {
+            const ScopedLock lock(midiLock_);
+            if (learnMidi(msg)) return;
         }
 
-        for (auto &ap: midiAutomation_) {
-            auto &a = ap.second;
-            if ((msg.isController() && a.midi_.type_ == MidiAutomation::Midi::T_CC)
-                && (msg.getControllerNumber() == a.midi_.num_)
-                ) {
-                automateParam(a.paramIdx_, a, msg);
-            } else if ((msg.isNoteOnOrOff() && a.midi_.type_ == MidiAutomation::Midi::T_NOTE)
-                       && (msg.getNoteNumber() == a.midi_.num_)) {
-                automateParam(a.paramIdx_, a, msg);
+        // mark the table in use, then check it is still active, so a rebuild will not reuse it
+        auto dispatch = activeDispatch_.load();
+        for (;;) {
+            dispatchReading_.store(dispatch);
+            auto active = activeDispatch_.load();
+            if (active == dispatch) break;
+            dispatch = active;
+        }
+
+        int ch = msg.getChannel() - 1;
+        if (dispatch != nullptr && ch >= 0 && ch < int(MidiDispatch::MAX_CHANNELS)) {
+            if (msg.isController()) {
+                int cc = msg.getControllerNumber();
+                int val = msg.getControllerValue();
+                queueParam(*dispatch, dispatch->cc_[cc], float(val) / 127.0f);
+
+                // 14 bit, msb resets lsb
+                constexpr float scale14 = 1.0f / 16383.0f;
+                if (cc < int(MidiDispatch::MAX_CC14)) {
+                    midiMsb_[ch][cc] = val;
+                    queueParam(*dispatch, dispatch->cc14_[cc], float(val << 7) * scale14);
+                } else if (cc < int(MidiDispatch::MAX_CC14 * 2)) {
+                    int msbCC = cc - MidiDispatch::MAX_CC14;
+                    queueParam(*dispatch, dispatch->cc14_[msbCC], float((midiMsb_[ch][msbCC] << 7) | val) * scale14);
+                }
+            } else if (msg.isNoteOn()) {
+                queueParam(*dispatch, dispatch->note_[msg.getNoteNumber()], msg.getFloatVelocity());
+            } else if (msg.isNoteOff()) {
+                queueParam(*dispatch, dispatch->note_[msg.getNoteNumber()], 0.0f);
+            } else if (msg.isChannelPressure()) {
+                float val = float(msg.getChannelPressureValue()) / 127.0f;
+                queueParam(*dispatch, dispatch->pressure_, val);
             }
         }
+        dispatchReading_.store(nullptr);
 
         if (noteInput_ && msg.isNoteOnOrOff()) {
             if (msg.isNoteOn()) {
@@ -390,6 +800,7 @@ void BaseProcessor::midiLearn(bool b) {
         midiLearn_ = b;
         if (midiLearn_) {
             lastLearn_.reset();
+            learntIdx_ = -1;
         }
     }
 }
@@ -402,37 +813,57 @@ void BaseProcessor::audioProcessorParameterChanged(AudioProcessor *processor,
     if (midiLearn_) {
         lastLearn_.paramIdx_ = parameterIndex;
     } else {
-        if (midiOutDevice_ != nullptr) {
-            if (midiAutomation_.find(parameterIndex) != midiAutomation_.end()) {
-                auto &a = midiAutomation_[parameterIndex];
-                switch (a.midi_.type_) {
-                    case MidiAutomation::Midi::T_CC : {
-                        auto msg = MidiMessage::controllerEvent(a.midi_.channel_, a.midi_.num_, uint8(v * 127));
-                        midiOutDevice_->sendMessageNow(msg);
-                        break;
-                    }
-                    case MidiAutomation::Midi::T_NOTE : {
-                        if (v > 0.0f) {
-                            auto msg = MidiMessage::noteOn(a.midi_.channel_, a.midi_.num_, uint8(v * 127));
-                            midiOutDevice_->sendMessageNow(msg);
-                        } else {
-                            auto msg = MidiMessage::noteOff(a.midi_.channel_, a.midi_.num_);
-                            midiOutDevice_->sendMessageNow(msg);
-                        }
-                        break;
-                    }
-                    case MidiAutomation::Midi::T_PRESSURE : {
-                        auto msg = MidiMessage::channelPressureChange(a.midi_.channel_, uint8(v * 127));
-                        midiOutDevice_->sendMessageNow(msg);
-                        break;
-                    }
-                    default: {
-                        break;
-                    }
+        // may be called from any thread, just note latest value, sent by sendMidiAutomation
+        if (midiOutOpen_.load(std::memory_order_relaxed) && parameterIndex >= 0 && parameterIndex < int(pendingSize_)) {
+            outParams_[parameterIndex].store(v, std::memory_order_release);
+        }
+    }
+}
+
+void BaseProcessor::sendMidiAutomation() {
+    MidiBuffer buf;
+    const ScopedLock lock(midiLock_);
+    if (midiOutDevice_ == nullptr) return;
+
+    for (auto &ap: midiAutomation_) {
+        auto &a = ap.second;
+        if (a.paramIdx_ < 0 || a.paramIdx_ >= int(pendingSize_)) continue;
+        float v = outParams_[a.paramIdx_].exchange(std::numeric_limits<float>::quiet_NaN(), std::memory_order_acq_rel);
+        if (std::isnan(v)) continue;
+
+        switch (a.midi_.type_) {
+            case MidiAutomation::Midi::T_CC : {
+                buf.addEvent(MidiMessage::controllerEvent(a.midi_.channel_, a.midi_.num_, uint8(v * 127)), 0);
+                break;
+            }
+            case MidiAutomation::Midi::T_CC14 : {
+                int v14 = jlimit(0, 16383, int(v * 16383.0f + 0.5f));
+                buf.addEvent(MidiMessage::controllerEvent(a.midi_.channel_, a.midi_.num_, v14 >> 7), 0);
+                buf.addEvent(MidiMessage::controllerEvent(a.midi_.channel_, a.midi_.num_ + 32, v14 & 0x7F), 0);
+                break;
+            }
+            case MidiAutomation::Midi::T_NOTE : {
+                if (v > 0.0f) {
+                    buf.addEvent(MidiMessage::noteOn(a.midi_.channel_, a.midi_.num_, uint8(v * 127)), 0);
+                } else {
+                    buf.addEvent(MidiMessage::noteOff(a.midi_.channel_, a.midi_.num_), 0);
                 }
+                break;
+            }
+            case MidiAutomation::Midi::T_PRESSURE : {
+                buf.addEvent(MidiMessage::channelPressureChange(a.midi_.channel_, uint8(v * 127)), 0);
+                break;
+            }
+            default: {
+                break;
             }
         }
     }
+
+    // queued for the midi output background thread, so the message thread does not block on the device
+    if (!buf.isEmpty()) {
+        midiOutDevice_->sendBlockOfMessages(buf, Time::getMillisecondCounterHiRes(), 1000.0);
+    }
 }
 
 }
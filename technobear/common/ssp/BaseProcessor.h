@@ -3,11 +3,18 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
 using namespace juce;
 
 #include "SSP.h"
 
 #include "BaseParameter.h"
+#include "DspLoad.h"
+#include "Meters.h"
 
 namespace ssp {
 
@@ -48,6 +55,14 @@ public:
     void getStateInformation(MemoryBlock &destData) override;
     void setStateInformation(const void *data, int sizeInBytes) override;
 
+    // called by every host wrapper (SSP_PluginInterface::process, juce vst3 etc)
+    // applies midi automation and pending state, times the block, and calls processAudio
+    using AudioProcessor::processBlock;
+    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) final;
+
+    // module processing, audio thread
+    virtual void processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) = 0;
+
 
     RangedAudioParameter *getParameter(StringRef n) { return apvts.getParameter(n); }
 
@@ -70,6 +85,46 @@ public:
 
     void midiLearn(bool b);
 
+    // applies parameter changes from midi automation received since last call
+    // audio thread, called by processBlock before processAudio
+    // values are set without notifying, listeners (and host) are notified from the message thread
+    void applyMidiAutomation();
+
+    // rebuild midi dispatch, call after midiAutomation() has been changed (holding midiAutomationLock())
+    void midiAutomationChanged();
+
+    void removeMidiAutomation(int paramIdx);
+
+    // two phase state load, the state is decoded, and midi/custom state applied, on a worker thread
+    // then parameters are switched by the audio thread at a block boundary
+    // outputs marked with fadeOnStateLoad are faded out before, and in after, the switch
+    // midi and custom state must not change audio processing, modules where they would (or that rebuild
+    // engines on load) return false from asyncStateLoad, and like older (xml) states, or loads while audio
+    // is not running, use setStateInformation on the calling thread
+    void loadStateAsync(const void *data, int sizeInBytes);
+
+    // audio thread, called by processBlock before and after processAudio
+    void applyPendingState();
+    void fadePendingState(AudioSampleBuffer &buffer);
+
+    // stop loader before destruction, as it calls derived classes (customFromXml)
+    void stopStateLoader();
+
+    // dsp load, timed by processBlock around each block
+    DspLoad &dspLoad() { return dspLoad_; }
+
+    // input/output levels, measured by processBlock before and after each block (for every host wrapper)
+    // only measured while they are being read (by the ui)
+    Meters::Level inputLevel(unsigned ch) {
+        meterReadMs_.store(Time::getMillisecondCounter(), std::memory_order_relaxed);
+        return inMeters_.level(ch);
+    }
+
+    Meters::Level outputLevel(unsigned ch) {
+        meterReadMs_.store(Time::getMillisecondCounter(), std::memory_order_relaxed);
+        return outMeters_.level(ch);
+    }
+
     virtual void midiNoteInput(unsigned note, unsigned velocity) { ; }
 
     void noteInput(bool b) { noteInput_ = b; }
@@ -96,6 +151,22 @@ protected:
     virtual void customFromXml(juce::XmlElement *);
     virtual void customToXml(juce::XmlElement *);
 
+    // state, binary format with xml fallback
+    bool decodeState(const void *data, int sizeInBytes, std::map<uint32, float> &values,
+                     std::unique_ptr<juce::XmlElement> &xml);
+    void stateValues(const std::map<uint32, float> &values, float *normValues);
+    void applyStateValues(const float *normValues);
+    bool stateFromBinary(const void *data, int sizeInBytes);
+    void vstFromXml(juce::XmlElement *);
+
+    // see loadStateAsync
+    virtual bool asyncStateLoad() { return true; }
+
+    // audio outputs, faded across a background state load, cv/gate outputs should be left to switch
+    void fadeOnStateLoad(unsigned ch) {
+        if (ch < numOut) stateFadeMask_ |= (1u << ch);
+    }
+
 
 #if __APPLE__
     virtual void testFromXml(juce::XmlElement *);
@@ -115,6 +186,7 @@ protected:
     void handleIncomingMidiMessage(MidiInput *source, const MidiMessage &message) override;
 
     void handleMidi(const MidiMessage &message);
+    bool learnMidi(const MidiMessage &message);
 
     struct MidiAutomation {
         int paramIdx_ = -1;
@@ -127,6 +199,7 @@ protected:
                 T_CC,
                 T_PRESSURE,
                 T_NOTE,
+                T_CC14, // 14 bit, msb on num (0-31), lsb on num + 32
                 T_MAX
             } type_ = T_MAX;
         } midi_;
@@ -146,14 +219,145 @@ protected:
         void recall(XmlElement *);
     };
 
-    void automateParam(int idx,const MidiAutomation& a, const MidiMessage &msg);
+    // midi automation, indexed by controller/note to parameter targets
+    // automation responds on any channel (the midi channel setting filters all input)
+    // rebuilt (into the inactive table) when automation changes, read by the midi thread
+    struct MidiDispatch {
+        static constexpr unsigned MAX_CHANNELS = 16;
+        static constexpr unsigned MAX_NUM = 128;
+        static constexpr unsigned MAX_TARGETS = 256;
+        static constexpr unsigned MAX_CC14 = 32;
+
+        struct Target {
+            int paramIdx_;
+            float scale_;
+            float offset_;
+            int16_t next_; // next target for same controller, -1 = end
+        };
+
+        int16_t cc_[MAX_NUM];
+        int16_t note_[MAX_NUM];
+        int16_t pressure_;
+        int16_t cc14_[MAX_CC14];
+        Target targets_[MAX_TARGETS];
+
+        void build(const std::map<int, MidiAutomation> &automation);
+    };
+
+    void queueParam(const MidiDispatch &dispatch, int16_t target, float val);
 
+    // automation and dispatch rebuilds are changed from midi, ui and loader threads, serialised by midiLock_
+    // the midi thread (single reader) marks the table it walks in dispatchReading_
+    // a rebuild waits for it to leave the table before reusing it
+    CriticalSection midiLock_;
     std::map<int, MidiAutomation> midiAutomation_;
+    MidiDispatch midiDispatch_[2];
+    std::atomic<MidiDispatch *> activeDispatch_{nullptr};
+    std::atomic<const MidiDispatch *> dispatchReading_{nullptr};
+
+    // parameter writes from midi thread, latest value per parameter (NaN = none)
+    // with a queue of parameter indexes that have a value pending, applied once per block
+    std::unique_ptr<std::atomic<float>[]> pendingParams_;
+    std::unique_ptr<int[]> pendingQueue_;
+    unsigned pendingSize_ = 0;
+    std::atomic<unsigned> pendingWr_{0};
+    std::atomic<unsigned> pendingRd_{0};
+    // last msb received, for 14 bit cc
+    uint8 midiMsb_[MidiDispatch::MAX_CHANNELS][MidiDispatch::MAX_CC14] = {};
+    // automation learnt last, switched to 14 bit if followed by its lsb
+    int learntIdx_ = -1;
+
+    // parameters set on the audio thread (midi automation, state load), notified from the message thread (NaN = none)
+    static constexpr int NOTIFY_INTERVAL = 10; // ms
+    std::unique_ptr<std::atomic<float>[]> notifyParams_;
+    void setValueDeferNotify(int paramIdx, float val);
+    void notifyParameters();
+
+    class NotifyTimer : public juce::Timer {
+    public:
+        explicit NotifyTimer(BaseProcessor &p) : processor_(p) { ; }
+
+        void timerCallback() override { processor_.notifyParameters(); }
+
+    private:
+        BaseProcessor &processor_;
+    } notifyTimer_{*this};
+
+    // outgoing automation, latest value per parameter (NaN = none), written from any thread
+    // sent from the message thread every MIDI_OUT_INTERVAL, through the midi output background thread
+    static constexpr int MIDI_OUT_INTERVAL = 10; // ms
+    std::unique_ptr<std::atomic<float>[]> outParams_;
+    void sendMidiAutomation();
+
+    class MidiOutTimer : public juce::Timer {
+    public:
+        explicit MidiOutTimer(BaseProcessor &p) : processor_(p) { ; }
+
+        void timerCallback() override { processor_.sendMidiAutomation(); }
+
+    private:
+        BaseProcessor &processor_;
+    } midiOutTimer_{*this};
+
+    // background state load
+    static constexpr uint32 STATE_IDLE_MS = 100; // audio considered stopped
+    void loadState(const MemoryBlock &data);
+
+    class StateLoader : public juce::Thread {
+    public:
+        explicit StateLoader(BaseProcessor &p) : Thread("ssp state loader"), processor_(p) { ; }
+
+        void run() override;
+
+    private:
+        BaseProcessor &processor_;
+    } stateLoader_{*this};
+
+    CriticalSection stateLoadLock_;
+    MemoryBlock stateLoadData_;
+    bool stateLoadPending_ = false;
+    // normalised values per parameter index, owned by loader until ready, then by audio thread
+    std::unique_ptr<float[]> stateValues_;
+    std::atomic<bool> stateReady_{false};
+    std::atomic<uint32> lastBlockMs_{0};
+    enum { FADE_NONE, FADE_OUT, FADE_IN } stateFade_ = FADE_NONE;
+    uint32 stateFadeMask_ = 0;
+    static_assert(numOut <= 32, "fade mask covers all outputs");
+
+    // meters, idle if not read for METER_IDLE_MS
+    static constexpr uint32 METER_IDLE_MS = 500;
+    static_assert(numIn <= Meters::MAX_CH && numOut <= Meters::MAX_CH, "meters cover all channels");
+    Meters inMeters_, outMeters_;
+    std::atomic<uint32> meterReadMs_{0};
+    void meter(Meters &meters, const AudioSampleBuffer &buffer, const bool *enabled, unsigned nCh);
+    void meterInputs(const AudioSampleBuffer &buffer);
+    void meterOutputs(const AudioSampleBuffer &buffer);
+
+    // dsp load, optionally logged (appended) to the file named by SSP_DSP_LOG in the environment
+    static constexpr int DSP_LOG_INTERVAL = 5000; // ms
+    DspLoad dspLoad_;
+    String dspLogFile_;
+    void logDspLoad();
+
+    // benchmarking only, set SSP_KEEP_DENORMALS in the environment to process without flushing denormals
+    // to measure what flushing saves (see ssp-rtcheck --bench)
+    bool keepDenormals_ = false;
+
+    class DspLogTimer : public juce::Timer {
+    public:
+        explicit DspLogTimer(BaseProcessor &p) : processor_(p) { ; }
+
+        void timerCallback() override { processor_.logDspLoad(); }
+
+    private:
+        BaseProcessor &processor_;
+    } dspLogTimer_{*this};
 
     std::string midiInDeviceName_;
     std::string midiOutDeviceName_;
     std::unique_ptr<MidiInput> midiInDevice_;
-    std::unique_ptr<MidiOutput> midiOutDevice_;
+    std::unique_ptr<MidiOutput> midiOutDevice_; // guarded by midiLock_
+    std::atomic<bool> midiOutOpen_{false}; // any thread, if parameter changes should be noted for midi out
     int midiChannel_ = 0;
     bool midiLearn_ = false;
     bool noteInput_ = false;
@@ -163,6 +367,8 @@ protected:
 public:
     std::map<int, MidiAutomation> &midiAutomation() { return midiAutomation_; }
 
+    CriticalSection &midiAutomationLock() { return midiLock_; }
+
 private:
     std::string getMidiInputDeviceId(const std::string& name);
     std::string getMidiOutputDeviceId(const std::string& name);
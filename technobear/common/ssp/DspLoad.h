@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace ssp {
+
+// dsp load of a processor, as a fraction of the block duration
+// audio thread times each block, stats are published once per window (~1 second), and read from any thread
+class DspLoad {
+public:
+    static constexpr float XRUN_RISK = 0.8f; // block used more than this of its budget
+    static constexpr float WINDOW_SECS = 1.0f;
+
+    struct Stats {
+        float mean = 0.0f;
+        float p99 = 0.0f;
+        float max = 0.0f;
+        unsigned xruns = 0; // blocks over XRUN_RISK, since start
+    };
+
+    // audio thread
+    inline void begin() { start_ = juce::Time::getHighResolutionTicks(); }
+
+    inline void end(int numSamples, double sampleRate) {
+        if (numSamples <= 0 || sampleRate <= 0.0) return;
+        auto ticks = juce::Time::getHighResolutionTicks() - start_;
+        double budget = double(numSamples) / sampleRate * tickRate_;
+        float load = float(double(ticks) / budget);
+
+        sum_ += load;
+        if (load > max_) max_ = load;
+        int bin = int(load * float(N_BINS - 1) / MAX_LOAD);
+        hist_[bin < 0 ? 0 : (bin >= int(N_BINS) ? N_BINS - 1 : bin)]++;
+        if (load > XRUN_RISK) xruns_++;
+
+        blocks_++;
+        samples_ += unsigned(numSamples);
+        if (float(samples_) >= float(sampleRate) * WINDOW_SECS) publish();
+    }
+
+    // any thread, stats of the last complete window
+    Stats stats() const { return published_[current_.load(std::memory_order_acquire)]; }
+
+private:
+    static constexpr unsigned N_BINS = 256;
+    static constexpr float MAX_LOAD = 2.0f; // top bin holds anything over
+
+    void publish() {
+        unsigned p99Count = blocks_ - (blocks_ / 100);
+        unsigned count = 0, bin = 0;
+        for (; bin < N_BINS - 1; bin++) {
+            count += hist_[bin];
+            if (count >= p99Count) break;
+        }
+
+        unsigned next = current_.load(std::memory_order_relaxed) ^ 1;
+        Stats &s = published_[next];
+        s.mean = sum_ / float(blocks_);
+        s.max = max_;
+        s.p99 = float(bin + 1) * MAX_LOAD / float(N_BINS - 1);
+        if (s.p99 > max_) s.p99 = max_;
+        s.xruns = xruns_;
+        current_.store(next, std::memory_order_release);
+
+        sum_ = 0.0f;
+        max_ = 0.0f;
+        blocks_ = 0;
+        samples_ = 0;
+        memset(hist_, 0, sizeof(hist_));
+    }
+
+    const double tickRate_ = double(juce::Time::getHighResolutionTicksPerSecond());
+    juce::int64 start_ = 0;
+
+    // current window, audio thread only
+    float sum_ = 0.0f;
+    float max_ = 0.0f;
+    unsigned blocks_ = 0;
+    unsigned samples_ = 0;
+    unsigned xruns_ = 0;
+    unsigned hist_[N_BINS] = {};
+
+    Stats published_[2];
+    std::atomic<unsigned> current_{0};
+};
+
+}
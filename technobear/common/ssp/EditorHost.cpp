@@ -5,6 +5,7 @@
 #include "BaseEditor.h"
 #include "BaseProcessor.h"
 #include "SSP.h"
+#include "FrameScheduler.h"
 
 
 namespace ssp {
@@ -71,6 +72,15 @@ void EditorHost::setMenuBounds(ValueButton &btn, unsigned r) {
     btn.setBounds(x, y, w, h);
 }
 
+void EditorHost::paint(Graphics &g) {
+    if (!panel_.isValid()) {
+        panel_ = Image(Image::RGB, jmax(getWidth(), 1), jmax(getHeight(), 1), false);
+        Graphics pg(panel_);
+        drawBasicPanel(pg);
+    }
+    g.drawImageAt(panel_, 0, 0);
+}
+
 void EditorHost::drawBasicPanel(Graphics &g) {
     g.fillAll(Colour(0xff111111));
 
@@ -181,8 +191,23 @@ void EditorHost::onRightShiftButton(bool v) {
 }
 
 void EditorHost::onSSPTimer() {
+    if (!sspVisible_ || !FrameScheduler::get().update(lastUpdate_)) return;
     editor_->onSSPTimer();
 }
 
+void EditorHost::sspVisible(bool b) {
+    if (sspVisible_ == b) return;
+    sspVisible_ = b;
+    if (b) {
+        if (editorTimer_ > 0) editor_->startTimer(editorTimer_);
+        if (systemTimer_ > 0) system_->startTimer(systemTimer_);
+    } else {
+        editorTimer_ = editor_->getTimerInterval();
+        systemTimer_ = system_->getTimerInterval();
+        editor_->stopTimer();
+        system_->stopTimer();
+    }
+}
+
 
 }
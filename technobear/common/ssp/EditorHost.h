@@ -22,11 +22,10 @@ public:
     explicit EditorHost(BaseProcessor *p, BaseEditor *e);
     ~EditorHost();
 
-    void paint(Graphics &g) override {
-        drawBasicPanel(g);
-    }
+    void paint(Graphics &g) override;
 
     void resized() override {
+        panel_ = Image();
         system_->resized();
         editor_->resized();
         if(sspui_) sspui_->resized();
@@ -44,11 +43,17 @@ public:
     void onRightShiftButton(bool v) override;
     void onSSPTimer() override;
 
+    // host visibility, hidden editors do no updates, and their timers are stopped
+    void sspVisible(bool b);
+
 private:
     void drawMenuBox(Graphics &g);
     void drawButtonBox(Graphics &g);
     void drawBasicPanel(Graphics &g);
 
+    // basic panel is static, so pre-rendered, redrawn on resize
+    Image panel_;
+
 
     void setMenuBounds(ValueButton &btn, unsigned r);
 
@@ -65,6 +70,11 @@ private:
 
     SSPUI *sspui_= nullptr;
 
+    bool sspVisible_ = true;
+    juce::uint32 lastUpdate_ = 0;
+    int editorTimer_ = 0;
+    int systemTimer_ = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditorHost)
 };
 
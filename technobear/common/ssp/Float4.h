@@ -0,0 +1,258 @@
+#pragma once
+
+// 4 lane float vector, NEON on the SSP (and arm macs), scalar fallback elsewhere
+// note: NEON does not support denormals, results may differ slightly from scalar code
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SSP_USE_NEON 1
+#endif
+
+#include <cstdint>
+#include <cmath>
+
+namespace ssp {
+
+struct alignas(16) float4 {
+    static constexpr unsigned N = 4;
+
+    // 2^x on [0,1), x * (c0 + x * (c1 ...)) + 1, least squares fit on relative error
+    static constexpr float POW2_C[5] = {0.69315159f, 0.24016431f, 0.05579394f, 0.00903089f, 0.00185888f};
+
+#ifdef SSP_USE_NEON
+    float32x4_t v;
+
+    float4() = default;
+
+    float4(float32x4_t x) : v(x) { ; }
+
+    static float4 dup(float x) { return vdupq_n_f32(x); }
+
+    static float4 load(const float *p) { return vld1q_f32(p); }
+
+    void store(float *p) const { vst1q_f32(p, v); }
+
+    float get(unsigned i) const {
+        alignas(16) float a[N];
+        vst1q_f32(a, v);
+        return a[i];
+    }
+
+    float4 operator+(const float4 &b) const { return vaddq_f32(v, b.v); }
+
+    float4 operator-(const float4 &b) const { return vsubq_f32(v, b.v); }
+
+    float4 operator*(const float4 &b) const { return vmulq_f32(v, b.v); }
+
+    // a + (b * c)
+    static float4 madd(const float4 &a, const float4 &b, const float4 &c) { return vmlaq_f32(a.v, b.v, c.v); }
+
+    static float4 min(const float4 &a, const float4 &b) { return vminq_f32(a.v, b.v); }
+
+    static float4 max(const float4 &a, const float4 &b) { return vmaxq_f32(a.v, b.v); }
+
+    // reciprocal estimate, refined with two newton-raphson steps
+    static float4 recip(const float4 &a) {
+        float32x4_t r = vrecpeq_f32(a.v);
+        r = vmulq_f32(vrecpsq_f32(a.v, r), r);
+        r = vmulq_f32(vrecpsq_f32(a.v, r), r);
+        return r;
+    }
+
+    float hsum() const {
+        float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+
+    // truncate towards zero
+    void toInt(int32_t *p) const { vst1q_s32(p, vcvtq_s32_f32(v)); }
+
+    static float4 fromInt(const int32_t *p) { return vcvtq_f32_s32(vld1q_s32(p)); }
+
+    // per lane mask select, m[i] ? a : b , mask lanes must be 0 or 0xFFFFFFFF
+    static float4 select(const uint32_t *m, const float4 &a, const float4 &b) {
+        return vbslq_f32(vld1q_u32(m), a.v, b.v);
+    }
+
+    // per lane mask, a[i] < b[i]
+    static void lt(const float4 &a, const float4 &b, uint32_t *m) { vst1q_u32(m, vcltq_f32(a.v, b.v)); }
+
+    static float4 abs(const float4 &a) { return vabsq_f32(a.v); }
+
+    // square root, reciprocal sqrt estimate refined with two newton-raphson steps, a >= 0
+    static float4 sqrt(const float4 &a) {
+        // avoid 0 * inf for zero lanes
+        float32x4_t x = vmaxq_f32(a.v, vdupq_n_f32(1e-30f));
+        float32x4_t r = vrsqrteq_f32(x);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, r), r), r);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, r), r), r);
+        return vmulq_f32(x, r);
+    }
+
+    static float4 floor(const float4 &a) {
+        float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(a.v));
+        // truncation rounds negatives up
+        uint32x4_t adj = vandq_u32(vcgtq_f32(t, a.v), vreinterpretq_u32_f32(vdupq_n_f32(1.0f)));
+        return vsubq_f32(t, vreinterpretq_f32_u32(adj));
+    }
+
+    // 2^x, polynomial on fractional part, relative error < 2e-7
+    static float4 pow2(const float4 &x) {
+        float32x4_t xc = vmaxq_f32(vminq_f32(x.v, vdupq_n_f32(126.0f)), vdupq_n_f32(-126.0f));
+        int32x4_t i = vcvtq_s32_f32(xc);
+        // truncation rounds negatives up, adjust to floor
+        uint32x4_t adj = vcgtq_f32(vcvtq_f32_s32(i), xc);
+        i = vsubq_s32(i, vreinterpretq_s32_u32(vandq_u32(adj, vdupq_n_u32(1))));
+        float32x4_t f = vsubq_f32(xc, vcvtq_f32_s32(i));
+        float32x4_t p = vdupq_n_f32(POW2_C[4]);
+        p = vmlaq_f32(vdupq_n_f32(POW2_C[3]), p, f);
+        p = vmlaq_f32(vdupq_n_f32(POW2_C[2]), p, f);
+        p = vmlaq_f32(vdupq_n_f32(POW2_C[1]), p, f);
+        p = vmlaq_f32(vdupq_n_f32(POW2_C[0]), p, f);
+        p = vmlaq_f32(vdupq_n_f32(1.0f), p, f);
+        int32x4_t e = vshlq_n_s32(vaddq_s32(i, vdupq_n_s32(127)), 23);
+        return vmulq_f32(p, vreinterpretq_f32_s32(e));
+    }
+
+#else
+    float v[N];
+
+    float4() = default;
+
+    static float4 dup(float x) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = x;
+        return r;
+    }
+
+    static float4 load(const float *p) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = p[i];
+        return r;
+    }
+
+    void store(float *p) const {
+        for (unsigned i = 0; i < N; i++) p[i] = v[i];
+    }
+
+    float get(unsigned i) const { return v[i]; }
+
+    float4 operator+(const float4 &b) const {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = v[i] + b.v[i];
+        return r;
+    }
+
+    float4 operator-(const float4 &b) const {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = v[i] - b.v[i];
+        return r;
+    }
+
+    float4 operator*(const float4 &b) const {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = v[i] * b.v[i];
+        return r;
+    }
+
+    static float4 madd(const float4 &a, const float4 &b, const float4 &c) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = a.v[i] + (b.v[i] * c.v[i]);
+        return r;
+    }
+
+    static float4 min(const float4 &a, const float4 &b) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+        return r;
+    }
+
+    static float4 max(const float4 &a, const float4 &b) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+        return r;
+    }
+
+    static float4 recip(const float4 &a) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = 1.0f / a.v[i];
+        return r;
+    }
+
+    float hsum() const { return (v[0] + v[1]) + (v[2] + v[3]); }
+
+    void toInt(int32_t *p) const {
+        for (unsigned i = 0; i < N; i++) p[i] = static_cast<int32_t>(v[i]);
+    }
+
+    static float4 fromInt(const int32_t *p) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = static_cast<float>(p[i]);
+        return r;
+    }
+
+    static float4 select(const uint32_t *m, const float4 &a, const float4 &b) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = m[i] ? a.v[i] : b.v[i];
+        return r;
+    }
+
+    static void lt(const float4 &a, const float4 &b, uint32_t *m) {
+        for (unsigned i = 0; i < N; i++) m[i] = a.v[i] < b.v[i] ? 0xFFFFFFFF : 0;
+    }
+
+    static float4 abs(const float4 &a) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = std::fabs(a.v[i]);
+        return r;
+    }
+
+    static float4 sqrt(const float4 &a) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = std::sqrt(a.v[i] > 0.0f ? a.v[i] : 0.0f);
+        return r;
+    }
+
+    static float4 floor(const float4 &a) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = std::floor(a.v[i]);
+        return r;
+    }
+
+    static float4 pow2(const float4 &x) {
+        float4 r;
+        for (unsigned i = 0; i < N; i++) r.v[i] = std::exp2(x.v[i]);
+        return r;
+    }
+
+#endif
+
+    float4 &operator+=(const float4 &b) { return *this = *this + b; }
+
+    float4 &operator-=(const float4 &b) { return *this = *this - b; }
+
+    float4 &operator*=(const float4 &b) { return *this = *this * b; }
+
+    static float4 clamp(const float4 &a, const float4 &lo, const float4 &hi) { return min(max(a, lo), hi); }
+
+    // sin(2 pi x), x in cycles, taylor series to x^11 on a quarter cycle, abs error < 2.5e-7
+    static float4 sin2pi(const float4 &x) {
+        // reduce to -0.5..0.5 , then fold to -0.25..0.25 as sin(pi - a) = sin(a)
+        float4 r = x - floor(x + dup(0.5f));
+        r = min(r, dup(0.5f) - r);
+        r = max(r, dup(-0.5f) - r);
+        float4 a = r * dup(2.0f * float(M_PI));
+        float4 a2 = a * a;
+        float4 p = madd(dup(1.0f / 362880.0f), a2, dup(-1.0f / 39916800.0f));
+        p = madd(dup(-1.0f / 5040.0f), a2, p);
+        p = madd(dup(1.0f / 120.0f), a2, p);
+        p = madd(dup(-1.0f / 6.0f), a2, p);
+        p = madd(dup(1.0f), a2, p);
+        return a * p;
+    }
+
+    // cos(2 pi x), x in cycles
+    static float4 cos2pi(const float4 &x) { return sin2pi(x + dup(0.25f)); }
+};
+
+} // namespace ssp
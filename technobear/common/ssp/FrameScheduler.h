@@ -0,0 +1,43 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace ssp {
+
+// paces editor updates (onSSPTimer work) driven by the host's frameStart
+// each editor updates at most every FRAME_INTERVAL ms, and at most MAX_UPDATES_PER_FRAME editors
+// update in one host frame, others are deferred to the next frame
+// hidden editors are not scheduled at all, see EditorHost::sspVisible
+class FrameScheduler {
+public:
+    static constexpr juce::uint32 FRAME_INTERVAL = 40; // ms, 25 fps
+    static constexpr juce::uint32 FRAME_WINDOW = 8; // ms, frameStart calls this close are the same host frame
+    static constexpr unsigned MAX_UPDATES_PER_FRAME = 2;
+
+    static FrameScheduler &get() {
+        static FrameScheduler scheduler;
+        return scheduler;
+    }
+
+    // ui thread, true if editor (last updated at lastUpdate) should update this frame
+    bool update(juce::uint32 &lastUpdate) {
+        auto now = juce::Time::getMillisecondCounter();
+        if (now - frameStart_ > FRAME_WINDOW) {
+            frameStart_ = now;
+            updates_ = 0;
+        }
+
+        if (now - lastUpdate < FRAME_INTERVAL || updates_ >= MAX_UPDATES_PER_FRAME) return false;
+        updates_++;
+        lastUpdate = now;
+        return true;
+    }
+
+private:
+    FrameScheduler() = default;
+
+    juce::uint32 frameStart_ = 0;
+    unsigned updates_ = 0;
+};
+
+}
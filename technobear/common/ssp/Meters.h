@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Float4.h"
+
+#include <atomic>
+#include <cmath>
+
+namespace ssp {
+
+// peak, rms and true peak levels of a set of channels, measured once per block
+// each channel is measured in a single pass (float4), true peak includes interpolated midpoints between samples
+// levels are smoothed over ~300ms, and published (double buffered) so the ui can read without locking
+class Meters {
+public:
+    static constexpr unsigned MAX_CH = 24;
+    static constexpr float SMOOTH_SECS = 0.3f;
+
+    struct Level {
+        float peak = 0.0f;
+        float rms = 0.0f;
+        float truePeak = 0.0f;
+    };
+
+    // audio thread
+    void reset() {
+        for (unsigned c = 0; c < MAX_CH; c++) smooth_[c] = Level();
+        nCh_ = 0;
+        publish();
+    }
+
+    // channels that are nullptr (e.g. disabled) decay to zero
+    void process(const float *const *channels, unsigned nCh, unsigned n, float sampleRate) {
+        if (n == 0 || sampleRate <= 0.0f) return;
+        nCh_ = nCh < MAX_CH ? nCh : MAX_CH;
+        const float a = std::exp(-float(n) / (sampleRate * SMOOTH_SECS));
+
+        for (unsigned c = 0; c < nCh_; c++) {
+            Level blk;
+            if (channels[c] != nullptr) measure(channels[c], n, blk);
+            Level &s = smooth_[c];
+            s.peak = blk.peak + (a * (s.peak - blk.peak));
+            s.rms = blk.rms + (a * (s.rms - blk.rms));
+            // instant attack
+            s.truePeak = blk.truePeak > s.truePeak ? blk.truePeak : blk.truePeak + (a * (s.truePeak - blk.truePeak));
+        }
+        publish();
+    }
+
+    // any thread
+    Level level(unsigned ch) const {
+        if (ch >= MAX_CH) return Level();
+        return published_[current_.load(std::memory_order_acquire)][ch];
+    }
+
+private:
+    // single pass, peak, sum of squares, and midpoints (-x0 + 9 x1 + 9 x2 - x3) / 16 for true peak
+    static void measure(const float *x, unsigned n, Level &l) {
+        const float4 c9 = float4::dup(9.0f / 16.0f);
+        const float4 c1 = float4::dup(1.0f / 16.0f);
+        float4 pk = float4::dup(0.0f);
+        float4 sq = float4::dup(0.0f);
+        float4 tp = float4::dup(0.0f);
+
+        unsigned i = 0;
+        for (; i + float4::N + 3 <= n; i += float4::N) {
+            float4 x0 = float4::load(x + i);
+            float4 x1 = float4::load(x + i + 1);
+            float4 x2 = float4::load(x + i + 2);
+            float4 x3 = float4::load(x + i + 3);
+            pk = float4::max(pk, float4::abs(x0));
+            sq = float4::madd(sq, x0, x0);
+            float4 mid = ((x1 + x2) * c9) - ((x0 + x3) * c1);
+            tp = float4::max(tp, float4::abs(mid));
+        }
+
+        alignas(16) float v[float4::N];
+        pk.store(v);
+        float peak = std::fmax(std::fmax(v[0], v[1]), std::fmax(v[2], v[3]));
+        float sum = sq.hsum();
+        tp.store(v);
+        float truePeak = std::fmax(std::fmax(v[0], v[1]), std::fmax(v[2], v[3]));
+
+        for (; i < n; i++) {
+            peak = std::fmax(peak, std::fabs(x[i]));
+            sum += x[i] * x[i];
+            if (i + 3 < n) {
+                float mid = ((x[i + 1] + x[i + 2]) * (9.0f / 16.0f)) - ((x[i] + x[i + 3]) * (1.0f / 16.0f));
+                truePeak = std::fmax(truePeak, std::fabs(mid));
+            }
+        }
+
+        l.peak = peak;
+        l.rms = std::sqrt(sum / float(n));
+        l.truePeak = std::fmax(truePeak, peak);
+    }
+
+    void publish() {
+        unsigned next = current_.load(std::memory_order_relaxed) ^ 1;
+        for (unsigned c = 0; c < MAX_CH; c++) {
+            published_[next][c] = c < nCh_ ? smooth_[c] : Level();
+        }
+        current_.store(next, std::memory_order_release);
+    }
+
+    unsigned nCh_ = 0;
+    Level smooth_[MAX_CH];
+    Level published_[2][MAX_CH];
+    std::atomic<unsigned> current_{0};
+};
+
+}
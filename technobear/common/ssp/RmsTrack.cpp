@@ -1 +0,0 @@
-#include "RmsTrack.h"
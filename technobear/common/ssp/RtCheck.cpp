@@ -0,0 +1,250 @@
+#include "RtCheck.h"
+
+#ifdef SSP_RT_CHECK
+
+// plugins are linked with -Bsymbolic when checking, so calls from plugin code (including juce)
+// bind to the definitions below, rather than those of libc/libstdc++
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <unistd.h>
+
+extern "C" {
+void *__libc_malloc(size_t);
+void *__libc_calloc(size_t, size_t);
+void *__libc_realloc(void *, size_t);
+void *__libc_memalign(size_t, size_t);
+void __libc_free(void *);
+}
+
+namespace {
+
+// initial exec, so tls access does not itself allocate
+__thread int rtDepth __attribute__((tls_model("initial-exec"))) = 0;
+__thread bool rtReporting __attribute__((tls_model("initial-exec"))) = false;
+
+std::atomic<unsigned> rtViolations{0};
+bool rtAbort = false;
+
+using MutexLockFn = int (*)(pthread_mutex_t *);
+MutexLockFn rtMutexLock = nullptr;
+MutexLockFn rtMutexTryLock = nullptr;
+
+inline bool inAudio() { return rtDepth > 0 && !rtReporting; }
+
+void report(const char *what) {
+    rtReporting = true;
+    rtViolations++;
+
+    static const char *prefix = "SSP_RT_CHECK: ";
+    static const char *suffix = " on audio thread\n";
+    write(STDERR_FILENO, prefix, strlen(prefix));
+    write(STDERR_FILENO, what, strlen(what));
+    write(STDERR_FILENO, suffix, strlen(suffix));
+
+    // backtrace_symbols_fd does not allocate
+    void *frames[32];
+    int n = backtrace(frames, 32);
+    backtrace_symbols_fd(frames, n, STDERR_FILENO);
+
+    rtReporting = false;
+    if (rtAbort) abort();
+}
+
+struct RtCheckInit {
+    RtCheckInit() {
+        // first backtrace loads the unwinder (which allocates), do it now
+        void *frames[1];
+        backtrace(frames, 1);
+        rtMutexLock = reinterpret_cast<MutexLockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        rtMutexTryLock = reinterpret_cast<MutexLockFn>(dlsym(RTLD_NEXT, "pthread_mutex_trylock"));
+        rtAbort = getenv("SSP_RT_CHECK_ABORT") != nullptr;
+    }
+} rtCheckInit;
+
+}
+
+namespace ssp {
+
+RtCheck::Scope::Scope() {
+    rtDepth++;
+}
+
+RtCheck::Scope::~Scope() {
+    rtDepth--;
+}
+
+unsigned RtCheck::violations() {
+    return rtViolations.load();
+}
+
+}
+
+extern "C" {
+
+void *malloc(size_t n) {
+    if (inAudio()) report("malloc");
+    return __libc_malloc(n);
+}
+
+void *calloc(size_t n, size_t sz) {
+    if (inAudio()) report("calloc");
+    return __libc_calloc(n, sz);
+}
+
+void *realloc(void *p, size_t n) {
+    if (inAudio()) report("realloc");
+    return __libc_realloc(p, n);
+}
+
+void free(void *p) {
+    if (p != nullptr && inAudio()) report("free");
+    __libc_free(p);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *m) {
+    if (rtMutexLock == nullptr) {
+        rtMutexLock = reinterpret_cast<MutexLockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    }
+    if (inAudio()) report("pthread_mutex_lock");
+    return rtMutexLock(m);
+}
+
+// does not block, but a lock taken on the audio thread is still contended by (and so delays) other threads
+int pthread_mutex_trylock(pthread_mutex_t *m) {
+    if (rtMutexTryLock == nullptr) {
+        rtMutexTryLock = reinterpret_cast<MutexLockFn>(dlsym(RTLD_NEXT, "pthread_mutex_trylock"));
+    }
+    if (inAudio()) report("pthread_mutex_trylock");
+    return rtMutexTryLock(m);
+}
+
+void *memalign(size_t align, size_t n) {
+    if (inAudio()) report("memalign");
+    return __libc_memalign(align, n);
+}
+
+void *aligned_alloc(size_t align, size_t n) {
+    if (inAudio()) report("aligned_alloc");
+    return __libc_memalign(align, n);
+}
+
+int posix_memalign(void **p, size_t align, size_t n) {
+    if (inAudio()) report("posix_memalign");
+    if (align < sizeof(void *) || (align & (align - 1)) != 0) return EINVAL;
+    *p = __libc_memalign(align, n);
+    return *p != nullptr ? 0 : ENOMEM;
+}
+
+}
+
+// libstdc++ operator new calls malloc from libstdc++, so would not be seen
+void *operator new(size_t n) {
+    if (inAudio()) report("new");
+    void *p = __libc_malloc(n == 0 ? 1 : n);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t n) {
+    if (inAudio()) report("new[]");
+    void *p = __libc_malloc(n == 0 ? 1 : n);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    if (p != nullptr && inAudio()) report("delete");
+    __libc_free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    if (p != nullptr && inAudio()) report("delete[]");
+    __libc_free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    operator delete[](p);
+}
+
+void *operator new(size_t n, const std::nothrow_t &) noexcept {
+    if (inAudio()) report("new(nothrow)");
+    return __libc_malloc(n == 0 ? 1 : n);
+}
+
+void *operator new[](size_t n, const std::nothrow_t &) noexcept {
+    if (inAudio()) report("new[](nothrow)");
+    return __libc_malloc(n == 0 ? 1 : n);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    operator delete[](p);
+}
+
+// over aligned types (e.g. float4 members, where alignment exceeds the default for new)
+void *operator new(size_t n, std::align_val_t al) {
+    if (inAudio()) report("new(align)");
+    void *p = __libc_memalign(size_t(al), n == 0 ? 1 : n);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t n, std::align_val_t al) {
+    if (inAudio()) report("new[](align)");
+    void *p = __libc_memalign(size_t(al), n == 0 ? 1 : n);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(size_t n, std::align_val_t al, const std::nothrow_t &) noexcept {
+    if (inAudio()) report("new(align, nothrow)");
+    return __libc_memalign(size_t(al), n == 0 ? 1 : n);
+}
+
+void *operator new[](size_t n, std::align_val_t al, const std::nothrow_t &) noexcept {
+    if (inAudio()) report("new[](align, nothrow)");
+    return __libc_memalign(size_t(al), n == 0 ? 1 : n);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+    if (p != nullptr && inAudio()) report("delete(align)");
+    __libc_free(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept {
+    if (p != nullptr && inAudio()) report("delete[](align)");
+    __libc_free(p);
+}
+
+void operator delete(void *p, size_t, std::align_val_t al) noexcept {
+    operator delete(p, al);
+}
+
+void operator delete[](void *p, size_t, std::align_val_t al) noexcept {
+    operator delete[](p, al);
+}
+
+void operator delete(void *p, std::align_val_t al, const std::nothrow_t &) noexcept {
+    operator delete(p, al);
+}
+
+void operator delete[](void *p, std::align_val_t al, const std::nothrow_t &) noexcept {
+    operator delete[](p, al);
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace ssp {
+
+// real time safety checker, enabled with the SSP_RT_CHECK cmake option (linux only)
+// while a Scope is active on a thread (the audio thread, see BaseProcessor::processBlock)
+// malloc/free/new/delete (including aligned variants) and pthread mutex locks from plugin code
+// are reported, with a backtrace, on stderr
+// set SSP_RT_CHECK_ABORT in the environment to abort on the first violation
+class RtCheck {
+public:
+#ifdef SSP_RT_CHECK
+    struct Scope {
+        Scope();
+        ~Scope();
+    };
+
+    // number of violations reported, since load
+    static unsigned violations();
+#else
+    struct Scope {
+        Scope() { ; }
+    };
+
+    static unsigned violations() { return 0; }
+#endif
+};
+
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "Float4.h"
+
+namespace ssp {
+
+// in memory bank of snapshots, each a set of raw (0..1) parameter values
+// single writer (message thread), single reader (audio thread)
+// each slot has three buffers, a store never fills the published buffer or the one the reader holds
+// so a held snapshot stays intact until released, however often the slot is stored
+template<unsigned N_VALUES, unsigned N_SLOTS = 16>
+class SnapshotBank {
+public:
+    static constexpr unsigned MAX_SLOTS = N_SLOTS;
+
+    SnapshotBank() {
+        for (auto &s: slots_) s.published_ = nullptr;
+    }
+
+    // writer
+    void store(unsigned slot, const float *values) {
+        if (slot >= N_SLOTS) return;
+        auto &s = slots_[slot];
+        const float *published = s.published_.load();
+        const float *held = held_.load();
+        float *buf = nullptr;
+        for (auto &b: s.buf_) {
+            if (b != published && b != held) {
+                buf = b;
+                break;
+            }
+        }
+        memcpy(buf, values, sizeof(float) * N_VALUES);
+        s.published_.store(buf);
+    }
+
+    // writer
+    void clear(unsigned slot) {
+        if (slot >= N_SLOTS) return;
+        slots_[slot].published_.store(nullptr);
+    }
+
+    // writer, nullptr if slot is empty
+    const float *get(unsigned slot) const {
+        if (slot >= N_SLOTS) return nullptr;
+        return slots_[slot].published_.load();
+    }
+
+    // reader, holds slot's snapshot (in place of any held before) until released
+    // nullptr if slot is empty, the snapshot held before is kept unless the slot was cleared during the call
+    const float *acquire(unsigned slot) {
+        if (slot >= N_SLOTS) return nullptr;
+        auto &s = slots_[slot];
+        const float *p = s.published_.load();
+        if (p == nullptr) return nullptr;
+        for (;;) {
+            // hold, then check it is still published, so the writer cannot have started filling it
+            held_.store(p);
+            const float *q = s.published_.load();
+            if (q == p) return p;
+            if (q == nullptr) {
+                held_.store(nullptr);
+                return nullptr;
+            }
+            p = q;
+        }
+    }
+
+    // reader
+    void release() { held_.store(nullptr); }
+
+    bool holding() const { return held_.load() != nullptr; }
+
+private:
+    struct Slot {
+        float buf_[3][N_VALUES];
+        std::atomic<const float *> published_;
+    } slots_[N_SLOTS];
+
+    std::atomic<const float *> held_{nullptr};
+};
+
+
+// snapshots of a set of parameters, with store, recall and slot selection
+// recall runs on the audio thread, crossfading (per block) from the values in use to the snapshot
+// then holds the snapshot until the message thread has set the parameters to match
+// stores (and loading from xml) are done on the message thread, the only writer of the bank
+template<unsigned N_VALUES, unsigned N_SLOTS = 16>
+class Snapshots : private juce::Timer {
+public:
+    using Parameter = juce::RangedAudioParameter;
+
+    // values : parameters held by a snapshot (N_VALUES)
+    // slot : base slot (1..N_SLOTS), xfade : recall crossfade time in ms
+    Snapshots(std::vector<Parameter *> values, Parameter &slot, Parameter &xfade) :
+        params_(std::move(values)), slot_(slot), xfade_(xfade) {
+        jassert(params_.size() == N_VALUES);
+        startTimer(SYNC_INTERVAL);
+    }
+
+    ~Snapshots() override {
+        stopTimer();
+    }
+
+    // any thread, taken from the parameters, into the base slot
+    void requestStore() { storeRequest_ = true; }
+
+    // any thread, recalled from the base slot (offset by cv) on the next block
+    void requestRecall() { recallRequest_ = true; }
+
+    // audio thread, once per block
+    // cv : slot offset (0..1 covers all slots), trig : recall on rising edge, nullptr if not patched
+    // without a trigger, cv recalls as it changes slot
+    // values : in, values in use, out, values to use during a recall
+    // returns false when values should come from the parameters
+    bool process(const float *cv, const float *trig, unsigned n, double sampleRate, float *values) {
+        bool recall = recallRequest_.exchange(false);
+
+        unsigned slot = slotFor(cv != nullptr ? cv[0] : 0.0f);
+        if (trig != nullptr) {
+            for (unsigned s = 0; s < n; s++) {
+                if (trig[s] > 0.5f && lastTrig_ <= 0.5f) recall = true;
+                lastTrig_ = trig[s];
+            }
+        } else if (cv != nullptr && lastSlot_ >= 0 && int(slot) != lastSlot_) {
+            recall = true;
+        }
+        lastSlot_ = int(slot);
+
+        if (recall) {
+            const float *snapshot = bank_.acquire(slot);
+            if (snapshot != nullptr) {
+                float xfadeMs = xfade_.convertFrom0to1(xfade_.getValue());
+                memcpy(from_, values, sizeof(float) * N_VALUES);
+                target_ = snapshot;
+                fadeLen_ = unsigned((xfadeMs * 0.001f * float(sampleRate) / float(std::max(n, 1u))) + 0.5f);
+                fadePos_ = 0;
+                synced_.store(nullptr, std::memory_order_release);
+                pending_.store(snapshot, std::memory_order_release);
+            } else if (!bank_.holding()) {
+                // slot cleared while acquiring, recall in progress was released
+                target_ = nullptr;
+            }
+        }
+
+        if (target_ == nullptr) return false;
+
+        if (fadePos_ < fadeLen_) {
+            fadePos_++;
+            blend(values, float(fadePos_) / float(fadeLen_));
+            return true;
+        }
+
+        if (synced_.load(std::memory_order_acquire) == target_) {
+            target_ = nullptr;
+            bank_.release();
+            return false;
+        }
+        memcpy(values, target_, sizeof(float) * N_VALUES);
+        return true;
+    }
+
+    // message thread
+    void toXml(juce::XmlElement *xml) const {
+        for (unsigned slot = 0; slot < N_SLOTS; slot++) {
+            const float *values = bank_.get(slot);
+            if (values == nullptr) continue;
+            juce::String str;
+            for (unsigned i = 0; i < N_VALUES; i++) {
+                if (i > 0) str << " ";
+                str << juce::String(values[i]);
+            }
+            auto xmlSnap = xml->createNewChildElement("snapshot");
+            xmlSnap->setAttribute("slot", int(slot));
+            xmlSnap->setAttribute("values", str);
+        }
+    }
+
+    // any thread, parsed here, stored into the bank on the message thread
+    void fromXml(juce::XmlElement *xml) {
+        {
+            const juce::ScopedLock lock(loadLock_);
+            for (auto &v: loadedValid_) v = false;
+            for (int idx = 0; idx < xml->getNumChildElements(); idx++) {
+                auto xmlSnap = xml->getChildElement(idx);
+                if (xmlSnap == nullptr || !xmlSnap->hasTagName("snapshot")) continue;
+                int slot = xmlSnap->getIntAttribute("slot", -1);
+                auto tokens = juce::StringArray::fromTokens(xmlSnap->getStringAttribute("values"), " ", "");
+                if (slot < 0 || slot >= int(N_SLOTS) || tokens.size() != int(N_VALUES)) continue;
+                for (unsigned i = 0; i < N_VALUES; i++) {
+                    loaded_[slot][i] = tokens[i].getFloatValue();
+                }
+                loadedValid_[slot] = true;
+            }
+            loadPending_ = true;
+        }
+        auto mm = juce::MessageManager::getInstanceWithoutCreating();
+        if (mm != nullptr && mm->isThisTheMessageThread()) storeLoaded();
+    }
+
+private:
+    static constexpr int SYNC_INTERVAL = 50; // ms
+
+    unsigned slotFor(float cv) const {
+        static constexpr int maxSlot = int(N_SLOTS) - 1;
+        int slot = int(slot_.convertFrom0to1(slot_.getValue())) - 1;
+        slot += int(cv * float(maxSlot + 1));
+        return unsigned(std::max(std::min(slot, maxSlot), 0));
+    }
+
+    void blend(float *values, float m) {
+        const float4 vm = float4::dup(m);
+        unsigned i = 0;
+        for (; i + float4::N <= N_VALUES; i += float4::N) {
+            float4 a = float4::load(from_ + i);
+            float4::madd(a, float4::load(target_ + i) - a, vm).store(values + i);
+        }
+        for (; i < N_VALUES; i++) {
+            values[i] = from_[i] + ((target_[i] - from_[i]) * m);
+        }
+    }
+
+    // message thread
+    void storeLoaded() {
+        const juce::ScopedLock lock(loadLock_);
+        if (!loadPending_) return;
+        loadPending_ = false;
+        for (unsigned slot = 0; slot < N_SLOTS; slot++) {
+            if (loadedValid_[slot]) bank_.store(slot, loaded_[slot]);
+            else bank_.clear(slot);
+        }
+    }
+
+    void timerCallback() override {
+        // bring parameters in line with a recalled snapshot
+        // still held by the audio thread, or the audio thread moved on and only this thread writes the bank
+        const float *snapshot = pending_.exchange(nullptr, std::memory_order_acq_rel);
+        if (snapshot != nullptr) {
+            for (unsigned i = 0; i < N_VALUES; i++) {
+                params_[i]->setValueNotifyingHost(snapshot[i]);
+            }
+            synced_.store(snapshot, std::memory_order_release);
+        }
+
+        if (storeRequest_.exchange(false)) {
+            float values[N_VALUES];
+            for (unsigned i = 0; i < N_VALUES; i++) {
+                values[i] = params_[i]->getValue();
+            }
+            bank_.store(slotFor(0.0f), values);
+        }
+
+        storeLoaded();
+    }
+
+    std::vector<Parameter *> params_;
+    Parameter &slot_;
+    Parameter &xfade_;
+
+    SnapshotBank<N_VALUES, N_SLOTS> bank_;
+    std::atomic<bool> storeRequest_{false};
+    std::atomic<bool> recallRequest_{false};
+
+    // loaded from xml, waiting to be stored
+    juce::CriticalSection loadLock_;
+    float loaded_[N_SLOTS][N_VALUES];
+    bool loadedValid_[N_SLOTS] = {};
+    bool loadPending_ = false;
+
+    // recall, audio thread
+    float from_[N_VALUES];
+    const float *target_ = nullptr;
+    unsigned fadeLen_ = 0;
+    unsigned fadePos_ = 0;
+    float lastTrig_ = 0.0f;
+    int lastSlot_ = -1;
+    std::atomic<const float *> pending_{nullptr};
+    std::atomic<const float *> synced_{nullptr};
+};
+
+}
@@ -162,9 +162,24 @@ void SystemEditor::drawView(Graphics &g) {
     g.drawSingleLineText(String("Num"), 540, y);
 
 
+    // dsp load, of last second
+    auto load = baseProcessor_->dspLoad().stats();
+    int ly = y;
+    g.drawSingleLineText("DSP Load", 920, ly);
+    g.setColour(load.max > DspLoad::XRUN_RISK ? Colours::orange : Colours::white);
+    ly += fh;
+    g.drawSingleLineText("mean " + String(load.mean * 100.0f, 1) + "%", 920, ly);
+    ly += fh;
+    g.drawSingleLineText("p99  " + String(load.p99 * 100.0f, 1) + "%", 920, ly);
+    ly += fh;
+    g.drawSingleLineText("max  " + String(load.max * 100.0f, 1) + "%", 920, ly);
+    ly += fh;
+    g.drawSingleLineText("xrun " + String(load.xruns), 920, ly);
+
     y += fh;
 
     auto &plist = baseProcessor_->getParameters();
+    const ScopedLock lock(baseProcessor_->midiAutomationLock());
     auto &am = baseProcessor_->midiAutomation();
 
     if (am.empty()) return;
@@ -191,6 +206,9 @@ void SystemEditor::drawView(Graphics &g) {
             case BaseProcessor::MidiAutomation::Midi::T_CC:
                 type = "CC";
                 break;
+            case BaseProcessor::MidiAutomation::Midi::T_CC14:
+                type = "CC14";
+                break;
             case BaseProcessor::MidiAutomation::Midi::T_NOTE:
                 type = "Note";
                 break;
@@ -258,6 +276,7 @@ void SystemEditor::noteInput(bool b) {
 void SystemEditor::deleteAutomation(bool b) {
     if (!b) {
         if (selIdx_ >= 0) {
+            const ScopedLock lock(baseProcessor_->midiAutomationLock());
             auto &am = baseProcessor_->midiAutomation();
             if (am.empty() || selIdx_ >= am.size()) return;
 
@@ -265,7 +284,7 @@ void SystemEditor::deleteAutomation(bool b) {
             for (auto ai = am.begin(); ai != am.end(); ai++) {
                 auto &a = ai->second;
                 if (idx == selIdx_) {
-                    am.erase(a.paramIdx_);
+                    baseProcessor_->removeMidiAutomation(a.paramIdx_);
                     if (selIdx_ != 0) {
                         selIdx_--;
                         if (selIdx_ < idxOffset_) idxOffset_ = selIdx_;
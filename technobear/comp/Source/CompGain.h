@@ -0,0 +1,239 @@
+#pragma once
+
+#include "ssp/Float4.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// linear <-> dB conversion
+// lin to dB is log2 from the exponent bits plus a table of the mantissa (with linear interpolation)
+// dB to lin uses the float4 2^x polynomial
+class DbLookup {
+public:
+    static constexpr unsigned TABLE_BITS = 8;
+    static constexpr unsigned TABLE_SIZE = 1 << TABLE_BITS;
+
+    static const DbLookup &get() {
+        static DbLookup lookup;
+        return lookup;
+    }
+
+    // x > 0 , anything smaller than MIN_LIN is treated as MIN_LIN
+    inline float lin2db(float x) const {
+        x = std::max(x, MIN_LIN);
+        uint32_t bits;
+        memcpy(&bits, &x, sizeof(bits));
+        int e = int(bits >> 23) - 127;
+        uint32_t m = bits & 0x7FFFFF;
+        uint32_t idx = m >> (23 - TABLE_BITS);
+        float frac = float(m & FRAC_MASK) * FRAC_SCALE;
+        float l2 = float(e) + log2_[idx] + ((log2_[idx + 1] - log2_[idx]) * frac);
+        return l2 * DB_PER_LOG2;
+    }
+
+    inline ssp::float4 lin2db(const ssp::float4 &x) const {
+        alignas(16) float v[ssp::float4::N];
+        x.store(v);
+        for (unsigned i = 0; i < ssp::float4::N; i++) v[i] = lin2db(v[i]);
+        return ssp::float4::load(v);
+    }
+
+    static inline float db2lin(float db) { return std::exp2(db * LOG2_PER_DB); }
+
+    static inline ssp::float4 db2lin(const ssp::float4 &db) {
+        return ssp::float4::pow2(db * ssp::float4::dup(LOG2_PER_DB));
+    }
+
+private:
+    DbLookup() {
+        for (unsigned i = 0; i <= TABLE_SIZE; i++) {
+            log2_[i] = float(std::log2(1.0 + double(i) / double(TABLE_SIZE)));
+        }
+    }
+
+    static constexpr float MIN_LIN = 1e-10f; // -200dB
+    static constexpr float DB_PER_LOG2 = 6.0205999f; // 20 * log10(2)
+    static constexpr float LOG2_PER_DB = 0.16609640f; // 1 / DB_PER_LOG2
+    static constexpr uint32_t FRAC_MASK = (1 << (23 - TABLE_BITS)) - 1;
+    static constexpr float FRAC_SCALE = 1.0f / float(1 << (23 - TABLE_BITS));
+
+    float log2_[TABLE_SIZE + 1];
+};
+
+
+// compressor gain computer, follows daisysp::Compressor (envelope, gain smoothing and auto makeup)
+// but works on blocks, the recursive parts run per sample, dB conversions are vectorised
+class CompGain {
+public:
+    void Init(float sampleRate) {
+        sampleRate_ = std::min(192000.0f, std::max(1.0f, sampleRate));
+        slopeRec_ = 0.1f;
+        gainRec_ = 0.1f;
+        ratio_ = 2.0f;
+        thresh_ = -12.0f;
+        attack_ = 0.1f;
+        release_ = 0.1f;
+        autoMakeup_ = true;
+        makeup_ = 0.0f;
+        recalculate();
+    }
+
+    void SetRatio(float r) { if (r != ratio_) { ratio_ = r; recalculate(); } }
+
+    void SetThreshold(float t) { if (t != thresh_) { thresh_ = t; recalculate(); } }
+
+    void SetAttack(float a) { if (a != attack_) { attack_ = a; recalculate(); } }
+
+    void SetRelease(float r) { if (r != release_) { release_ = r; recalculate(); } }
+
+    void SetMakeup(float db) { if (db != makeup_) { makeup_ = db; recalculate(); } }
+
+    void AutoMakeup(bool b) { if (b != autoMakeup_) { autoMakeup_ = b; recalculate(); } }
+
+    // detector : rectified level per sample, gain : linear gain per sample (may alias detector)
+    void Process(const float *detector, float *gain, unsigned n) {
+        const DbLookup &db = DbLookup::get();
+
+        // envelope
+        float slope = slopeRec_;
+        for (unsigned i = 0; i < n; i++) {
+            float d = detector[i];
+            float cur = slope > d ? relSlo_ : atkSlo_;
+            slope = (slope * cur) + ((1.0f - cur) * d);
+            gain[i] = slope;
+        }
+        slopeRec_ = slope;
+
+        // level over threshold, scaled to gain reduction
+        const ssp::float4 thresh = ssp::float4::dup(thresh_);
+        const ssp::float4 ratioMul = ssp::float4::dup(ratioMul_);
+        const ssp::float4 zero = ssp::float4::dup(0.0f);
+        unsigned i = 0;
+        for (; i + ssp::float4::N <= n; i += ssp::float4::N) {
+            ssp::float4 over = ssp::float4::max(db.lin2db(ssp::float4::load(gain + i)) - thresh, zero);
+            (over * ratioMul).store(gain + i);
+        }
+        for (; i < n; i++) {
+            gain[i] = std::max(db.lin2db(gain[i]) - thresh_, 0.0f) * ratioMul_;
+        }
+
+        // gain reduction smoothing
+        float gr = gainRec_;
+        for (i = 0; i < n; i++) {
+            gr = (atkSlo2_ * gr) + gain[i];
+            gain[i] = gr;
+        }
+        gainRec_ = gr;
+
+        // to linear
+        const ssp::float4 makeup = ssp::float4::dup(makeupGain_);
+        for (i = 0; i + ssp::float4::N <= n; i += ssp::float4::N) {
+            DbLookup::db2lin(ssp::float4::load(gain + i) + makeup).store(gain + i);
+        }
+        for (; i < n; i++) {
+            gain[i] = DbLookup::db2lin(gain[i] + makeupGain_);
+        }
+    }
+
+private:
+    void recalculate() {
+        float srInv = 1.0f / sampleRate_;
+        atkSlo2_ = expf(-2.0f * srInv / attack_);
+        atkSlo_ = expf(-srInv / attack_);
+        relSlo_ = expf(-srInv / release_);
+        ratioMul_ = (1.0f - atkSlo2_) * ((1.0f / ratio_) - 1.0f);
+        makeupGain_ = autoMakeup_ ? fabsf(thresh_ - (thresh_ / ratio_)) * 0.5f : makeup_;
+    }
+
+    float sampleRate_ = 48000.0f;
+    float ratio_ = 2.0f, thresh_ = -12.0f, attack_ = 0.1f, release_ = 0.1f, makeup_ = 0.0f;
+    bool autoMakeup_ = true;
+
+    float atkSlo_ = 0.0f, atkSlo2_ = 0.0f, relSlo_ = 0.0f, ratioMul_ = 0.0f, makeupGain_ = 0.0f;
+    float slopeRec_ = 0.1f;
+    float gainRec_ = 0.1f;
+};
+
+
+// gain computer with independent threshold, ratio and makeup per lane (e.g. bands of a multiband)
+// same maths as CompGain, attack and release are shared, lanes are processed together per sample
+class CompGain4 {
+public:
+    static constexpr unsigned N_LANES = ssp::float4::N;
+
+    void Init(float sampleRate) {
+        sampleRate_ = std::min(192000.0f, std::max(1.0f, sampleRate));
+        for (unsigned l = 0; l < N_LANES; l++) {
+            ratio_[l] = 2.0f;
+            thresh_[l] = -12.0f;
+            makeup_[l] = 0.0f;
+        }
+        attack_ = 0.1f;
+        release_ = 0.1f;
+        autoMakeup_ = true;
+        Reset();
+        recalculate();
+    }
+
+    void Reset() {
+        slopeRec_ = ssp::float4::dup(0.1f);
+        gainRec_ = ssp::float4::dup(0.1f);
+    }
+
+    void SetRatio(unsigned l, float r) { if (r != ratio_[l]) { ratio_[l] = r; recalculate(); } }
+
+    void SetThreshold(unsigned l, float t) { if (t != thresh_[l]) { thresh_[l] = t; recalculate(); } }
+
+    void SetMakeup(unsigned l, float db) { if (db != makeup_[l]) { makeup_[l] = db; recalculate(); } }
+
+    void SetAttack(float a) { if (a != attack_) { attack_ = a; recalculate(); } }
+
+    void SetRelease(float r) { if (r != release_) { release_ = r; recalculate(); } }
+
+    void AutoMakeup(bool b) { if (b != autoMakeup_) { autoMakeup_ = b; recalculate(); } }
+
+    // detector : rectified level per lane, returns linear gain per lane
+    inline ssp::float4 Process(const ssp::float4 &detector) {
+        const ssp::float4 one = ssp::float4::dup(1.0f);
+        const ssp::float4 zero = ssp::float4::dup(0.0f);
+
+        alignas(16) uint32_t falling[N_LANES];
+        ssp::float4::lt(detector, slopeRec_, falling);
+        ssp::float4 cur = ssp::float4::select(falling, relSlo_, atkSlo_);
+        slopeRec_ = ssp::float4::madd(slopeRec_ * cur, one - cur, detector);
+
+        ssp::float4 over = ssp::float4::max(DbLookup::get().lin2db(slopeRec_) - thresh4_, zero);
+        gainRec_ = ssp::float4::madd(atkSlo2_ * gainRec_, ratioMul_, over);
+        return DbLookup::db2lin(gainRec_ + makeupGain_);
+    }
+
+private:
+    void recalculate() {
+        float srInv = 1.0f / sampleRate_;
+        float atkSlo2 = expf(-2.0f * srInv / attack_);
+        atkSlo2_ = ssp::float4::dup(atkSlo2);
+        atkSlo_ = ssp::float4::dup(expf(-srInv / attack_));
+        relSlo_ = ssp::float4::dup(expf(-srInv / release_));
+
+        alignas(16) float ratioMul[N_LANES], makeupGain[N_LANES];
+        for (unsigned l = 0; l < N_LANES; l++) {
+            ratioMul[l] = (1.0f - atkSlo2) * ((1.0f / ratio_[l]) - 1.0f);
+            makeupGain[l] = autoMakeup_ ? fabsf(thresh_[l] - (thresh_[l] / ratio_[l])) * 0.5f : makeup_[l];
+        }
+        ratioMul_ = ssp::float4::load(ratioMul);
+        makeupGain_ = ssp::float4::load(makeupGain);
+        thresh4_ = ssp::float4::load(thresh_);
+    }
+
+    float sampleRate_ = 48000.0f;
+    alignas(16) float ratio_[N_LANES];
+    alignas(16) float thresh_[N_LANES];
+    alignas(16) float makeup_[N_LANES];
+    float attack_ = 0.1f, release_ = 0.1f;
+    bool autoMakeup_ = true;
+
+    ssp::float4 atkSlo_, atkSlo2_, relSlo_, ratioMul_, makeupGain_, thresh4_;
+    ssp::float4 slopeRec_;
+    ssp::float4 gainRec_;
+};
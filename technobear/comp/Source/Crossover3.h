@@ -0,0 +1,166 @@
+#pragma once
+
+#include "ssp/Float4.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 4 biquads (transposed direct form II), one per lane, each with its own coefficients
+class Biquad4 {
+public:
+    static constexpr unsigned N_LANES = ssp::float4::N;
+
+    enum Type {
+        LOWPASS,
+        HIGHPASS,
+        ALLPASS
+    };
+
+    Biquad4() {
+        for (unsigned l = 0; l < N_LANES; l++) {
+            b0_[l] = 1.0f;
+            b1_[l] = b2_[l] = a1_[l] = a2_[l] = 0.0f;
+        }
+        load();
+        reset();
+    }
+
+    void reset() {
+        z1_ = ssp::float4::dup(0.0f);
+        z2_ = ssp::float4::dup(0.0f);
+    }
+
+    // butterworth (q = 1/sqrt(2)) response, rbj cookbook
+    void setLane(unsigned l, Type type, float freq, float sampleRate) {
+        double w = 2.0 * M_PI * double(freq) / double(sampleRate);
+        double cs = cos(w);
+        double alpha = sin(w) / (2.0 * M_SQRT1_2);
+        double a0 = 1.0 + alpha;
+        double b0, b1, b2;
+        switch (type) {
+            case LOWPASS :
+                b0 = (1.0 - cs) * 0.5;
+                b1 = 1.0 - cs;
+                b2 = b0;
+                break;
+            case HIGHPASS :
+                b0 = (1.0 + cs) * 0.5;
+                b1 = -(1.0 + cs);
+                b2 = b0;
+                break;
+            default:
+                b0 = 1.0 - alpha;
+                b1 = -2.0 * cs;
+                b2 = 1.0 + alpha;
+                break;
+        }
+        b0_[l] = float(b0 / a0);
+        b1_[l] = float(b1 / a0);
+        b2_[l] = float(b2 / a0);
+        a1_[l] = float(-2.0 * cs / a0);
+        a2_[l] = float((1.0 - alpha) / a0);
+        load();
+    }
+
+    inline ssp::float4 process(const ssp::float4 &x) {
+        ssp::float4 y = ssp::float4::madd(z1_, b0v_, x);
+        z1_ = ssp::float4::madd(z2_, b1v_, x) - (a1v_ * y);
+        z2_ = (b2v_ * x) - (a2v_ * y);
+        return y;
+    }
+
+private:
+    void load() {
+        b0v_ = ssp::float4::load(b0_);
+        b1v_ = ssp::float4::load(b1_);
+        b2v_ = ssp::float4::load(b2_);
+        a1v_ = ssp::float4::load(a1_);
+        a2v_ = ssp::float4::load(a2_);
+    }
+
+    alignas(16) float b0_[N_LANES], b1_[N_LANES], b2_[N_LANES], a1_[N_LANES], a2_[N_LANES];
+    ssp::float4 b0v_, b1v_, b2v_, a1v_, a2v_;
+    ssp::float4 z1_, z2_;
+};
+
+
+// stereo 3 band linkwitz-riley (4th order) crossover
+// low is passed through an allpass at the high crossover, so the bands sum back flat
+// bands are returned as lanes {low, mid, high, 0}
+class Crossover3 {
+public:
+    enum {
+        B_LOW,
+        B_MID,
+        B_HIGH,
+        B_MAX
+    };
+
+    void init(float sampleRate) {
+        sampleRate_ = sampleRate;
+        lowFreq_ = highFreq_ = 0.0f;
+        setFreqs(200.0f, 2500.0f);
+        reset();
+    }
+
+    void reset() {
+        for (auto &f: split_) f.reset();
+        for (auto &f: high_) f.reset();
+        allpass_.reset();
+    }
+
+    void setFreqs(float lowFreq, float highFreq) {
+        float nyq = sampleRate_ * 0.45f;
+        lowFreq = std::min(lowFreq, nyq);
+        highFreq = std::min(std::max(highFreq, lowFreq), nyq);
+        if (lowFreq == lowFreq_ && highFreq == highFreq_) return;
+        lowFreq_ = lowFreq;
+        highFreq_ = highFreq;
+
+        // lanes {lp L, hp L, lp R, hp R}, a 4th order LR is two identical butterworth sections
+        for (auto &f: split_) {
+            f.setLane(0, Biquad4::LOWPASS, lowFreq_, sampleRate_);
+            f.setLane(1, Biquad4::HIGHPASS, lowFreq_, sampleRate_);
+            f.setLane(2, Biquad4::LOWPASS, lowFreq_, sampleRate_);
+            f.setLane(3, Biquad4::HIGHPASS, lowFreq_, sampleRate_);
+        }
+        for (auto &f: high_) {
+            f.setLane(0, Biquad4::LOWPASS, highFreq_, sampleRate_);
+            f.setLane(1, Biquad4::HIGHPASS, highFreq_, sampleRate_);
+            f.setLane(2, Biquad4::LOWPASS, highFreq_, sampleRate_);
+            f.setLane(3, Biquad4::HIGHPASS, highFreq_, sampleRate_);
+        }
+        // lanes {L, R, -, -}
+        for (unsigned l = 0; l < Biquad4::N_LANES; l++) {
+            allpass_.setLane(l, Biquad4::ALLPASS, highFreq_, sampleRate_);
+        }
+    }
+
+    inline void process(float inL, float inR, ssp::float4 &bandsL, ssp::float4 &bandsR) {
+        alignas(16) float v[Biquad4::N_LANES] = {inL, inL, inR, inR};
+        ssp::float4 x = ssp::float4::load(v);
+        for (auto &f: split_) x = f.process(x);
+        x.store(v);
+        // v = {low L, rest L, low R, rest R}
+
+        alignas(16) float lo[Biquad4::N_LANES] = {v[0], v[2], 0.0f, 0.0f};
+        alignas(16) float hi[Biquad4::N_LANES] = {v[1], v[1], v[3], v[3]};
+        allpass_.process(ssp::float4::load(lo)).store(lo);
+        x = ssp::float4::load(hi);
+        for (auto &f: high_) x = f.process(x);
+        x.store(hi);
+        // hi = {mid L, high L, mid R, high R}
+
+        alignas(16) float bl[Biquad4::N_LANES] = {lo[0], hi[0], hi[1], 0.0f};
+        alignas(16) float br[Biquad4::N_LANES] = {lo[1], hi[2], hi[3], 0.0f};
+        bandsL = ssp::float4::load(bl);
+        bandsR = ssp::float4::load(br);
+    }
+
+private:
+    float sampleRate_ = 48000.0f;
+    float lowFreq_ = 0.0f, highFreq_ = 0.0f;
+    Biquad4 split_[2];
+    Biquad4 high_[2];
+    Biquad4 allpass_;
+};
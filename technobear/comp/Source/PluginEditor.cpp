@@ -22,11 +22,27 @@ PluginEditor::PluginEditor(PluginProcessor &p)
 
     addParamPage(
         std::make_shared<pcontrol_type>(processor_.params_.makeup),
-        nullptr,
-        nullptr,
+        std::make_shared<pcontrol_type>(processor_.params_.detect, 1.0f, 1.0f),
+        std::make_shared<pcontrol_type>(processor_.params_.lookahead, 0.5f, 0.1f),
         nullptr
     );
 
+    addParamPage(
+        std::make_shared<pcontrol_type>(processor_.params_.mode, 1.0f, 1.0f),
+        std::make_shared<pcontrol_type>(processor_.params_.xlow, 10.0f, 1.0f),
+        std::make_shared<pcontrol_type>(processor_.params_.xhigh, 100.0f, 10.0f),
+        nullptr
+    );
+
+    for (auto &band: processor_.params_.bands) {
+        addParamPage(
+            std::make_shared<pcontrol_type>(band.threshold),
+            std::make_shared<pcontrol_type>(band.ratio),
+            std::make_shared<pcontrol_type>(band.makeup),
+            nullptr
+        );
+    }
+
 
     addButtonPage(
         std::make_shared<bcontrol_type>(processor_.params_.automakeup, 24, Colours::lightskyblue),
@@ -21,6 +21,8 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
     init();
+    fadeOnStateLoad(O_LEFT);
+    fadeOnStateLoad(O_RIGHT);
 }
 
 PluginProcessor::~PluginProcessor() {
@@ -33,7 +35,17 @@ PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt)
     attack(*apvt.getParameter(ID::attack)),
     release(*apvt.getParameter(ID::release)),
     makeup(*apvt.getParameter(ID::makeup)),
-    automakeup(*apvt.getParameter(ID::automakeup)) {
+    automakeup(*apvt.getParameter(ID::automakeup)),
+    detect(*apvt.getParameter(ID::detect)),
+    lookahead(*apvt.getParameter(ID::lookahead)),
+    mode(*apvt.getParameter(ID::mode)),
+    xlow(*apvt.getParameter(ID::xlow)),
+    xhigh(*apvt.getParameter(ID::xhigh)),
+    bands{
+        {*apvt.getParameter(ID::lothreshold), *apvt.getParameter(ID::loratio), *apvt.getParameter(ID::lomakeup)},
+        {*apvt.getParameter(ID::midthreshold), *apvt.getParameter(ID::midratio), *apvt.getParameter(ID::midmakeup)},
+        {*apvt.getParameter(ID::hithreshold), *apvt.getParameter(ID::hiratio), *apvt.getParameter(ID::himakeup)}
+    } {
 }
 
 
@@ -47,6 +59,22 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     params.add(std::make_unique<ssp::BaseFloatParameter>(ID::release, "Release", 0.001f, 10.0f, 0.1f));// 0.001 -> 10
     params.add(std::make_unique<ssp::BaseFloatParameter>(ID::makeup, "Makeup", 0.0f, 80.0f, 0.0f)); //  0.0 -> 80
     params.add(std::make_unique<ssp::BaseBoolParameter>(ID::automakeup, "AutoM", true));
+    // added after automakeup, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::detect, "Detect", StringArray{"Max", "RMS"}, D_MAX));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::lookahead, "Lookahead", 0.0f, MAX_LOOKAHEAD * 1000.0f, 0.0f, 0.1f)); // ms
+    // added after lookahead, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::mode, "Mode", StringArray{"Single", "3 Band"}, M_SINGLE));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::xlow, "X Low", 40.0f, 1000.0f, 200.0f, 1.0f)); // hz
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::xhigh, "X High", 1000.0f, 12000.0f, 2500.0f, 1.0f)); // hz
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::lothreshold, "Lo Thresh", -80.0f, 0.0f, -12.0f));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::loratio, "Lo Ratio", 1.0f, 40.0f, 2.0f));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::lomakeup, "Lo Makeup", 0.0f, 80.0f, 0.0f));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::midthreshold, "Mid Thresh", -80.0f, 0.0f, -12.0f));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::midratio, "Mid Ratio", 1.0f, 40.0f, 2.0f));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::midmakeup, "Mid Makeup", 0.0f, 80.0f, 0.0f));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::hithreshold, "Hi Thresh", -80.0f, 0.0f, -12.0f));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::hiratio, "Hi Ratio", 1.0f, 40.0f, 2.0f));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::himakeup, "Hi Makeup", 0.0f, 80.0f, 0.0f));
 
     return params;
 }
@@ -75,64 +103,172 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     BaseProcessor::prepareToPlay(sampleRate, samplesPerBlock);
     compressor_.Init(sampleRate);
+    workBuf_.setSize(1, samplesPerBlock);
+    lookaheadBuf_.setSize(2, int(std::ceil(MAX_LOOKAHEAD * sampleRate)) + 1);
+    lookaheadBuf_.clear();
+    bandDelayBuf_.setSize(2, lookaheadBuf_.getNumSamples() * ssp::float4::N);
+    bandDelayBuf_.clear();
+    lookaheadPos_ = 0;
+    crossover_.init(sampleRate);
+    keyCrossover_.init(sampleRate);
+    compBands_.Init(sampleRate);
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
-    size_t n = buffer.getNumSamples();
+void PluginProcessor::detect(AudioSampleBuffer &buffer, bool left, bool right, bool sidechain, float *det, unsigned n) {
+    if (sidechain) {
+        FloatVectorOperations::abs(det, buffer.getReadPointer(I_SIDECHAIN), n);
+        return;
+    }
+
+    if (!(left && right)) {
+        FloatVectorOperations::abs(det, buffer.getReadPointer(left ? I_LEFT : I_RIGHT), n);
+        return;
+    }
+
+    const float *inL = buffer.getReadPointer(I_LEFT);
+    const float *inR = buffer.getReadPointer(I_RIGHT);
+    if (params_.detect.getValue() > 0.5f) {
+        // D_RMS, sqrt((l*l + r*r) / 2)
+        FloatVectorOperations::multiply(det, inL, inL, n);
+        FloatVectorOperations::addWithMultiply(det, inR, inR, n);
+        for (unsigned s = 0; s < n; s++) {
+            det[s] = std::sqrt(det[s] * 0.5f);
+        }
+    } else {
+        // D_MAX
+        FloatVectorOperations::abs(det, inL, n);
+        for (unsigned s = 0; s < n; s++) {
+            det[s] = std::max(det[s], std::fabs(inR[s]));
+        }
+    }
+}
+
+void PluginProcessor::delayLookahead(AudioSampleBuffer &buffer, unsigned ch, unsigned delay, unsigned n) {
+    float *io = buffer.getWritePointer(ch);
+    float *line = lookaheadBuf_.getWritePointer(ch);
+    const unsigned sz = lookaheadBuf_.getNumSamples();
+    unsigned wr = lookaheadPos_;
+    unsigned rd = (wr + sz - delay) % sz;
+    for (unsigned s = 0; s < n; s++) {
+        line[wr] = io[s];
+        io[s] = line[rd];
+        if (++wr == sz) wr = 0;
+        if (++rd == sz) rd = 0;
+    }
+}
+
+void PluginProcessor::processBands(AudioSampleBuffer &buffer, bool left, bool right, bool sidechain,
+                                   unsigned delay, unsigned n) {
+    constexpr unsigned N = ssp::float4::N;
+    const bool rms = params_.detect.getValue() > 0.5f;
+    const ssp::float4 half = ssp::float4::dup(0.5f);
+    float *ioL = buffer.getWritePointer(I_LEFT);
+    float *ioR = buffer.getWritePointer(I_RIGHT);
+    const float *key = sidechain ? buffer.getReadPointer(I_SIDECHAIN) : nullptr;
+    float *lineL = bandDelayBuf_.getWritePointer(0);
+    float *lineR = bandDelayBuf_.getWritePointer(1);
+    const unsigned sz = lookaheadBuf_.getNumSamples();
+    unsigned wr = lookaheadPos_;
+    unsigned rd = (wr + sz - delay) % sz;
+
+    for (unsigned s = 0; s < n; s++) {
+        ssp::float4 bl, br;
+        crossover_.process(left ? ioL[s] : 0.0f, right ? ioR[s] : 0.0f, bl, br);
+
+        ssp::float4 det;
+        if (key != nullptr) {
+            ssp::float4 kl, kr;
+            keyCrossover_.process(key[s], 0.0f, kl, kr);
+            det = ssp::float4::abs(kl);
+        } else if (left && right) {
+            det = rms ? ssp::float4::sqrt(ssp::float4::madd(bl * bl, br, br) * half)
+                      : ssp::float4::max(ssp::float4::abs(bl), ssp::float4::abs(br));
+        } else {
+            det = ssp::float4::abs(left ? bl : br);
+        }
+        ssp::float4 gain = compBands_.Process(det);
+
+        bl.store(lineL + wr * N);
+        br.store(lineR + wr * N);
+        if (left) ioL[s] = (ssp::float4::load(lineL + rd * N) * gain).hsum();
+        if (right) ioR[s] = (ssp::float4::load(lineR + rd * N) * gain).hsum();
+        if (++wr == sz) wr = 0;
+        if (++rd == sz) rd = 0;
+    }
+}
+
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+    unsigned n = buffer.getNumSamples();
     float ratio = normValue(params_.ratio);
     float threshold = normValue(params_.threshold);
     float attack = normValue(params_.attack);
     float release = normValue(params_.release);
     float makeup = normValue(params_.makeup);
     bool automakeup = params_.automakeup.getValue() > 0.5f;
+    float lookahead = normValue(params_.lookahead) / 1000.0f;
+    bool bandMode = params_.mode.getValue() > 0.5f;
 
     bool sidechain = isInputEnabled(I_SIDECHAIN);
     bool stereoOut = isOutputEnabled(O_RIGHT);
-    bool stereoIn = isOutputEnabled(O_RIGHT);
-
+    bool stereoIn = isInputEnabled(I_RIGHT);
+    bool procL = isInputEnabled(I_LEFT) && isOutputEnabled(O_LEFT);
+    bool procR = stereoIn && stereoOut;
 
     compressor_.SetRatio(ratio);
     compressor_.SetThreshold(threshold);
     compressor_.SetAttack(attack);
     compressor_.SetRelease(release);
-    if(automakeup) {
-//        compressor_.SetMakeup(makeup);
-        compressor_.AutoMakeup(automakeup);
-    } else {
-        compressor_.AutoMakeup(automakeup);
-        compressor_.SetMakeup(makeup);
+    compressor_.AutoMakeup(automakeup);
+    if (!automakeup) compressor_.SetMakeup(makeup);
+
+    if (bandMode) {
+        if (!bandMode_) {
+            crossover_.reset();
+            keyCrossover_.reset();
+            compBands_.Reset();
+        }
+        crossover_.setFreqs(normValue(params_.xlow), normValue(params_.xhigh));
+        keyCrossover_.setFreqs(normValue(params_.xlow), normValue(params_.xhigh));
+        compBands_.SetAttack(attack);
+        compBands_.SetRelease(release);
+        compBands_.AutoMakeup(automakeup);
+        for (unsigned b = 0; b < Crossover3::B_MAX; b++) {
+            auto &band = params_.bands[b];
+            compBands_.SetThreshold(b, normValue(band.threshold));
+            compBands_.SetRatio(b, normValue(band.ratio));
+            compBands_.SetMakeup(b, normValue(band.makeup));
+        }
     }
+    bandMode_ = bandMode;
+
+    if (procL || procR) {
+        // audio is delayed, so gain reduction is in place before a transient arrives
+        // (always run through the delay line, so it holds current audio when look-ahead is turned up)
+        unsigned delay = std::min(unsigned(lookahead * getSampleRate() + 0.5f),
+                                  unsigned(lookaheadBuf_.getNumSamples() - 1));
 
-    inRms_[I_LEFT].process(buffer, I_LEFT);
-    if (stereoIn) inRms_[I_RIGHT].process(buffer, I_RIGHT);
-
-    bool sidechainDone = false;
-    for (unsigned i = I_LEFT; i <= I_RIGHT; i++) {
-        if (isInputEnabled(i) && isOutputEnabled(i)) {
-            for (int s = 0; s < n; s++) {
-                float in = buffer.getSample(i, s);
-                if (sidechain) {
-                    if (!sidechainDone) { // only needed to be done once
-                        float key = buffer.getSample(I_SIDECHAIN, s);
-                        compressor_.Process(key);
-                    }
-                    buffer.setSample(i, s, compressor_.Apply(in));
-                } else {
-                    buffer.setSample(i, s, compressor_.Process(in));
-                } // sidechain
-            } // per sample
-            if (sidechain) sidechainDone = true;
-        }// io enabled
-    } // channel
-
-    if (stereoOut && !isInputEnabled(I_RIGHT)) {
-        for (int s = 0; s < n; s++) {
-            buffer.setSample(O_RIGHT, s, buffer.getSample(O_LEFT, s));
+        if (bandMode) {
+            processBands(buffer, procL, procR, sidechain, delay, n);
+        } else {
+            if (workBuf_.getNumSamples() < int(n)) workBuf_.setSize(1, n, false, false, true);
+            float *gain = workBuf_.getWritePointer(0);
+
+            // one detector for both channels, so the stereo image is kept
+            detect(buffer, procL, procR, sidechain, gain, n);
+            compressor_.Process(gain, gain, n);
+
+            for (unsigned ch = I_LEFT; ch <= I_RIGHT; ch++) {
+                if (ch == I_LEFT ? !procL : !procR) continue;
+                delayLookahead(buffer, ch, delay, n);
+                FloatVectorOperations::multiply(buffer.getWritePointer(ch), gain, n);
+            }
         }
+        lookaheadPos_ = (lookaheadPos_ + n) % lookaheadBuf_.getNumSamples();
     }
 
-    outRms_[O_LEFT].process(buffer, O_LEFT);
-    if (stereoOut) outRms_[O_RIGHT].process(buffer, O_RIGHT);
+    if (stereoOut && !stereoIn) {
+        buffer.copyFrom(O_RIGHT, 0, buffer, O_LEFT, 0, n);
+    }
 }
 
 AudioProcessorEditor *PluginProcessor::createEditor() {
@@ -4,11 +4,11 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "ssp/BaseProcessor.h"
-#include "ssp/RmsTrack.h"
 
 #include <atomic>
 #include <algorithm>
-#include "daisysp.h"
+#include "CompGain.h"
+#include "Crossover3.h"
 
 namespace ID {
 #define PARAMETER_ID(str) constexpr const char* str { #str };
@@ -19,6 +19,20 @@ PARAMETER_ID (attack)
 PARAMETER_ID (release)
 PARAMETER_ID (makeup)
 PARAMETER_ID (automakeup)
+PARAMETER_ID (detect)
+PARAMETER_ID (lookahead)
+PARAMETER_ID (mode)
+PARAMETER_ID (xlow)
+PARAMETER_ID (xhigh)
+PARAMETER_ID (lothreshold)
+PARAMETER_ID (loratio)
+PARAMETER_ID (lomakeup)
+PARAMETER_ID (midthreshold)
+PARAMETER_ID (midratio)
+PARAMETER_ID (midmakeup)
+PARAMETER_ID (hithreshold)
+PARAMETER_ID (hiratio)
+PARAMETER_ID (himakeup)
 
 #undef PARAMETER_ID
 }
@@ -34,7 +48,7 @@ public:
 
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -49,13 +63,24 @@ public:
         Parameter &release;
         Parameter &makeup;
         Parameter &automakeup;
+        Parameter &detect;
+        Parameter &lookahead;
+        Parameter &mode;
+        Parameter &xlow;
+        Parameter &xhigh;
+
+        struct BandParams {
+            Parameter &threshold;
+            Parameter &ratio;
+            Parameter &makeup;
+        } bands[Crossover3::B_MAX];
     } params_;
 
     void getRMS(float &lIn, float &rIn, float &lOut, float &rOut) {
-        lIn = inRms_[0].lvl();
-        rIn = inRms_[1].lvl();
-        lOut = outRms_[0].lvl();
-        rOut = outRms_[1].lvl();
+        lIn = inputLevel(I_LEFT).peak;
+        rIn = inputLevel(I_RIGHT).peak;
+        lOut = outputLevel(O_LEFT).peak;
+        rOut = outputLevel(O_RIGHT).peak;
     }
 
     static BusesProperties getBusesProperties() {
@@ -85,7 +110,38 @@ private:
         O_MAX
     };
 
-    daisysp::Compressor compressor_;
+    enum {
+        D_MAX,
+        D_RMS
+    };
+
+    enum {
+        M_SINGLE,
+        M_3BAND
+    };
+
+    static constexpr float MAX_LOOKAHEAD = 0.005f; // seconds
+
+    // linked detector, left/right (or sidechain) into a single level
+    void detect(AudioSampleBuffer &buffer, bool left, bool right, bool sidechain, float *det, unsigned n);
+    void delayLookahead(AudioSampleBuffer &buffer, unsigned ch, unsigned delay, unsigned n);
+    void processBands(AudioSampleBuffer &buffer, bool left, bool right, bool sidechain, unsigned delay, unsigned n);
+
+    CompGain compressor_;
+
+    // 3 band mode, bands are the lanes of the crossover output and gain computer
+    Crossover3 crossover_;
+    Crossover3 keyCrossover_;
+    CompGain4 compBands_;
+    bool bandMode_ = false;
+
+    // detector level, then gain
+    AudioSampleBuffer workBuf_;
+
+    AudioSampleBuffer lookaheadBuf_;
+    // look-ahead for 3 band mode, a float4 of bands per sample
+    AudioSampleBuffer bandDelayBuf_;
+    unsigned lookaheadPos_ = 0;
 
     bool isBusesLayoutSupported(const BusesLayout &layouts) const override {
         return true;
@@ -94,9 +150,6 @@ private:
     static const String getInputBusName(int channelIndex);
     static const String getOutputBusName(int channelIndex);
 
-    ssp::RmsTrack inRms_[2];
-    ssp::RmsTrack outRms_[2];
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };
 
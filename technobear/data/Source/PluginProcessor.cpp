@@ -131,7 +131,7 @@ void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPe
     backoffTs_ = newSampleRate * (25.0f / 1000.0f);
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     if (params_.freeze.getValue() > 0.5f) return;
 
     unsigned n = buffer.getNumSamples();
@@ -28,6 +28,14 @@ PluginEditor::PluginEditor(PluginProcessor &p)
         view,
         Colours::orange
     );
+    addParamPage(
+        std::make_shared<pcontrol_type>(processor_.params_.interp, 1.0f, 1.0f),
+        nullptr,
+        nullptr,
+        nullptr,
+        view,
+        Colours::orange
+    );
 
     addButtonPage(
         std::make_shared<bcontrol_type>(processor_.params_.freeze, 24, Colours::lightskyblue),
@@ -57,7 +65,7 @@ PluginEditor::PluginEditor(PluginProcessor &p)
             std::make_shared<pcontrol_type>(t.lpf, 100, 5),
             std::make_shared<pcontrol_type>(t.hpf, 100, 5),
             std::make_shared<pcontrol_type>(t.noise, 1, 0.01),
-            nullptr,
+            std::make_shared<pcontrol_type>(t.sync, 1.0f, 1.0f),
             view,
             clrs[view % L_CLRS]
         );
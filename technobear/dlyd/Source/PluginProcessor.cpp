@@ -14,6 +14,7 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
     init();
+    for (unsigned i = 0; i < O_MAX; i++) fadeOnStateLoad(i);
 }
 
 PluginProcessor::~PluginProcessor() {
@@ -27,6 +28,16 @@ String getTapParamId(unsigned tid, StringRef id) {
     return getTapPid(tid) + String(ID::separator) + id;
 }
 
+// tap sync, tap time as ratio of clock period
+static constexpr unsigned N_SYNC = 14;
+static const char *syncNames[N_SYNC] = {
+    "Free", "1/16", "1/8", "1/4", "1/3", "1/2", "2/3", "3/4", "1", "3/2", "2", "3", "4", "8"
+};
+static constexpr float syncRatios[N_SYNC] = {
+    0.0f, 1.0f / 16.0f, 1.0f / 8.0f, 1.0f / 4.0f, 1.0f / 3.0f, 1.0f / 2.0f, 2.0f / 3.0f, 3.0f / 4.0f,
+    1.0f, 3.0f / 2.0f, 2.0f, 3.0f, 4.0f, 8.0f
+};
+
 inline float panGain(bool left, float p) {
     static constexpr float PIdiv2 = M_PI / 2.0f;
     float pan = (p + 1.0f) / 2.0f;
@@ -46,7 +57,8 @@ PluginProcessor::Tap::Tap(AudioProcessorValueTreeState &apvt, unsigned id) :
     noise(*apvt.getParameter(getTapParamId(id, ID::noise))),
     pan(*apvt.getParameter(getTapParamId(id, ID::pan))),
     level(*apvt.getParameter(getTapParamId(id, ID::level))),
-    feedback(*apvt.getParameter(getTapParamId(id, ID::feedback))) {
+    feedback(*apvt.getParameter(getTapParamId(id, ID::feedback))),
+    sync(*apvt.getParameter(getTapParamId(id, ID::sync))) {
 
 }
 
@@ -56,7 +68,8 @@ PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt)
     mix(*apvt.getParameter(ID::mix)),
     in_level(*apvt.getParameter(ID::in_level)),
     out_level(*apvt.getParameter(ID::out_level)),
-    freeze(*apvt.getParameter(ID::freeze)) {
+    freeze(*apvt.getParameter(ID::freeze)),
+    interp(*apvt.getParameter(ID::interp)) {
     for (unsigned tid = 0; tid < MAX_TAPS; tid++) {
         auto tap = std::make_unique<Tap>(apvt, tid);
         taps_.push_back(std::move(tap));
@@ -91,6 +104,25 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     }
     params.add(std::move(taps));
 
+    // added after taps, to keep parameter indexes (used by midi automation) stable
+    StringArray interps;
+    interps.add("Linear");
+    interps.add("Hermite");
+    interps.add("Allpass");
+    jassert(interps.size() == line_type::I_MAX);
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::interp, "Interp", interps, 0));
+
+    StringArray syncs;
+    for (unsigned i = 0; i < N_SYNC; i++) syncs.add(syncNames[i]);
+    auto tapsync = std::make_unique<AudioProcessorParameterGroup>(ID::tapsync, String(ID::tapsync), ID::separator);
+    for (unsigned tid = 0; tid < MAX_TAPS; tid++) {
+        char la[2];
+        la[0] = 'A' + tid;
+        la[1] = 0;
+        String desc = "Tap " + String(la) + " ";
+        tapsync->addChild(std::make_unique<ssp::BaseChoiceParameter>(getTapParamId(tid, ID::sync), desc + "Sync", syncs, 0));
+    }
+    params.add(std::move(tapsync));
 
     return params;
 }
@@ -107,7 +139,8 @@ const String PluginProcessor::getInputBusName(int channelIndex) {
         "Time 2 A",
         "Time 2 B",
         "Time 2 C",
-        "Time 2 D"
+        "Time 2 D",
+        "Clk In"
     };
     if (channelIndex < I_MAX) { return inBusName[channelIndex]; }
     return "ZZIn-" + String(channelIndex);
@@ -137,87 +170,178 @@ void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPe
     for (int line = 0; line < N_DLY_LINES; line++) {
         auto &dline = delayLines_[line];
         dline.line_.Init();
+        dline.filters_.Init(newSampleRate);
         for (int t = 0; t < MAX_TAPS; t++) {
-            dline.taps_[t].hpf_.Init(newSampleRate);
-            dline.taps_[t].lpf_.Init(newSampleRate);
-            dline.taps_[t].noise_.Init();
+            dline.noise_[t].Init();
         }
+        auto &v = tapValues_[line];
+        for (int t = 0; t < MAX_TAPS; t++) {
+            v.cur_[t] = v.prev_[t] = 0.0f;
+            v.upper_[t] = 0.0f;
+        }
+        v.fade_ = 1.0f;
+        v.fading_ = false;
     }
+    fadeInc_ = 1.0f / (XFADE_TIME * float(newSampleRate));
+    clkSampleCount_ = 0;
+    clkPeriod_ = 0;
 }
 
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processClock(AudioSampleBuffer &buffer) {
+    if (!inputEnabled[I_CLK]) return;
+
     unsigned sz = buffer.getNumSamples();
+    auto clk = buffer.getReadPointer(I_CLK);
+    for (unsigned s = 0; s < sz; s++) {
+        bool trig = clk[s] > CLK_TRIG_LEVEL && lastClkCv_ < CLK_TRIG_LEVEL;
+        lastClkCv_ = clk[s];
+        if (trig) {
+            clkPeriod_ = clkSampleCount_;
+            clkSampleCount_ = 0;
+        }
+        // stop counting once beyond longest delay, next trig starts again
+        if (clkSampleCount_ < MAX_DELAY) clkSampleCount_++;
+    }
+}
+
 
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     float size = params_.size.getValue();
     float mix = params_.mix.getValue();
     bool freeze = params_.freeze.getValue() > 0.5f;
     float inlvl = freeze ? 0.0f : normValue(params_.in_level) / 100.0f; // lvl can be > 100
     float outlvl = normValue(params_.out_level) / 100.0f;
     float maxtime = size * float(MAX_DELAY);
+    auto interp = line_type::Interp(int(normValue(params_.interp)));
 
-    inRms_[0].process(buffer, I_IN_1);
-    inRms_[1].process(buffer, I_IN_2);
-
-    struct {
-        float time_;
-        float level_;
-        float feedback_;
-        float noiseamt_;
-        float panamt_;
-    } tapvalues[N_DLY_LINES][MAX_TAPS];
+    processClock(buffer);
+    bool clkValid = inputEnabled[I_CLK] && clkPeriod_ > 0 && clkPeriod_ < MAX_DELAY;
 
     // control rate handling
     for (int line = 0; line < N_DLY_LINES; line++) {
+        auto &v = tapValues_[line];
+        auto &dline = delayLines_[line];
+        v.noise_ = false;
+        if (!v.fading_) {
+            // taps share the fade, so those not changing must fade from where they are
+            for (int t = 0; t < MAX_TAPS; t++) v.prev_[t] = v.cur_[t];
+        }
         for (int t = 0; t < MAX_TAPS; t++) {
-            auto &v = tapvalues[line][t];
-            auto &tap = delayLines_[line].taps_[t];
             auto &tap_params = params_.taps_[t];
 
-            v.time_ = tap_params->time.getValue();
-            v.level_ = tap_params->level.getValue();
-            v.feedback_ = tap_params->feedback.getValue();
-            v.noiseamt_ = tap_params->noise.getValue();
+            v.time_[t] = tap_params->time.getValue();
+            unsigned sync = unsigned(normValue(tap_params->sync));
+            float target;
+            if (clkValid && sync > 0 && sync < N_SYNC) {
+                // synced, cv still offsets relative to size
+                target = std::min(float(clkPeriod_) * syncRatios[sync], float(MAX_DELAY));
+                v.upper_[t] = float(MAX_DELAY);
+                if (!v.fading_) {
+                    // allow for clock jitter
+                    float tol = 2.0f + target * 0.002f;
+                    if (std::fabs(target - v.cur_[t]) > tol) {
+                        v.cur_[t] = target;
+                        v.fade_ = 0.0f;
+                    }
+                }
+            } else {
+                target = v.time_[t] * maxtime;
+                v.upper_[t] = maxtime;
+                v.cur_[t] = v.prev_[t] = target;
+            }
             float pan = normValue(tap_params->pan);
-            v.panamt_ = panGain(line == 0, pan);
+            v.level_[t] = tap_params->level.getValue() * panGain(line == 0, pan);
+            v.feedback_[t] = tap_params->feedback.getValue();
+            v.noiseamt_[t] = tap_params->noise.getValue();
+            v.noise_ |= v.noiseamt_[t] > 0.0f;
 
-            float hpf = normValue(tap_params->hpf);
-            float lpf = normValue(tap_params->lpf);
-            if (tap.lpf_.GetFreq() != lpf) tap.lpf_.SetFreq(lpf);
-            if (tap.hpf_.GetFreq() != hpf) tap.hpf_.SetFreq(hpf);
+            dline.filters_.SetFreq(t, normValue(tap_params->lpf), normValue(tap_params->hpf));
         }
+        dline.filters_.Update();
+        v.fading_ = v.fade_ < 1.0f;
+    }
+
+    switch (interp) {
+        case line_type::I_HERMITE :
+            processLines<line_type::I_HERMITE>(buffer, inlvl, outlvl, mix, maxtime);
+            break;
+        case line_type::I_ALLPASS :
+            processLines<line_type::I_ALLPASS>(buffer, inlvl, outlvl, mix, maxtime);
+            break;
+        case line_type::I_LINEAR :
+        default:
+            processLines<line_type::I_LINEAR>(buffer, inlvl, outlvl, mix, maxtime);
+            break;
     }
+}
+
+
+template<PluginProcessor::line_type::Interp I>
+void PluginProcessor::processLines(AudioSampleBuffer &buffer, float inlvl, float outlvl, float mix, float maxtime) {
+    const unsigned sz = buffer.getNumSamples();
+    const ssp::float4 zero = ssp::float4::dup(0.0f);
+    const ssp::float4 vmaxtime = ssp::float4::dup(maxtime);
 
     // sample rate processing
-    for (int s = 0; s < sz; s++) {
-        for (int line = 0; line < N_DLY_LINES; line++) {
-
-            auto &dlyline = delayLines_[line];
-            float in = buffer.getSample(line, s) * inlvl;
-            float wet = 0.0f;
-            float fbk = 0.0f;
-            for (int t = 0; t < MAX_TAPS; t++) {
-                auto &tv = tapvalues[line][t];
-                unsigned sigoffset = (line * MAX_TAPS) + t;
-                float cvtime = buffer.getSample(I_TIME_1_TA + sigoffset, s);
-                auto &tap = delayLines_[line].taps_[t];
-                float noisesig = tap.noise_.Process() * tv.noiseamt_;
-                float time = constrain(tv.time_ + cvtime, 0.0f, 1.0f) * maxtime;
-                float v = dlyline.line_.Read(time) + noisesig;
-                v = tap.lpf_.Process(v);
-                v = tap.hpf_.Process(v);
-                wet += v * tv.level_ * tv.panamt_;
-                fbk += v * tv.feedback_;
-                buffer.setSample(O_OUT_1_TA + sigoffset, s, v);
+    for (int line = 0; line < N_DLY_LINES; line++) {
+        auto &dlyline = delayLines_[line];
+        auto &tv = tapValues_[line];
+        const ssp::float4 cur = ssp::float4::load(tv.cur_);
+        const ssp::float4 prev = ssp::float4::load(tv.prev_);
+        const ssp::float4 upper = ssp::float4::load(tv.upper_);
+        const ssp::float4 level = ssp::float4::load(tv.level_);
+        const ssp::float4 feedback = ssp::float4::load(tv.feedback_);
+
+        const unsigned tapch = line * MAX_TAPS;
+        const float *cvtime[MAX_TAPS];
+        float *tapout[MAX_TAPS];
+        for (int t = 0; t < MAX_TAPS; t++) {
+            // note: time cv in and tap out share a channel
+            cvtime[t] = buffer.getReadPointer(I_TIME_1_TA + tapch + t);
+            tapout[t] = buffer.getWritePointer(O_OUT_1_TA + tapch + t);
+        }
+        float *io = buffer.getWritePointer(line);
+
+        for (int s = 0; s < sz; s++) {
+            float in = io[s] * inlvl;
+
+            alignas(16) float cv[MAX_TAPS];
+            for (int t = 0; t < MAX_TAPS; t++) cv[t] = cvtime[t][s];
+            ssp::float4 cvtime = ssp::float4::load(cv) * vmaxtime;
+            ssp::float4 dtime = ssp::float4::clamp(cur + cvtime, zero, upper);
+
+            ssp::float4 v = dlyline.line_.template Read<I>(dtime);
+            if (tv.fading_) {
+                // tempo change, crossfade from previous tap time
+                ssp::float4 ptime = ssp::float4::clamp(prev + cvtime, zero, upper);
+                ssp::float4 pv = dlyline.line_.template Read<I>(ptime, 1);
+                v = ssp::float4::madd(pv, v - pv, ssp::float4::dup(tv.fade_));
+                tv.fade_ += fadeInc_;
+                if (tv.fade_ >= 1.0f) {
+                    tv.fade_ = 1.0f;
+                    tv.fading_ = false;
+                }
+            }
+            if (tv.noise_) {
+                alignas(16) float noise[MAX_TAPS];
+                for (int t = 0; t < MAX_TAPS; t++) {
+                    noise[t] = tv.noiseamt_[t] > 0.0f ? dlyline.noise_[t].Process() * tv.noiseamt_[t] : 0.0f;
+                }
+                v += ssp::float4::load(noise);
             }
+            v = dlyline.filters_.Process(v);
+
+            alignas(16) float tv4[MAX_TAPS];
+            v.store(tv4);
+            for (int t = 0; t < MAX_TAPS; t++) tapout[t][s] = tv4[t];
+
+            float wet = (v * level).hsum();
+            float fbk = (v * feedback).hsum();
             dlyline.line_.Write(in + fbk);
-            float out = (in * (1.0f - mix) + wet) * outlvl;
-            buffer.setSample(line, s, out);
+            io[s] = (in * (1.0f - mix) + wet) * outlvl;
         }
     }
-
-    outRms_[0].process(buffer, O_OUT_1);
-    outRms_[1].process(buffer, O_OUT_2);
 }
 
 
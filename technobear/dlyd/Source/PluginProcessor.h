@@ -8,7 +8,7 @@
 
 #include <atomic>
 #include <algorithm>
-#include "ssp/RmsTrack.h"
+#include "TapDelayLine.h"
 
 
 namespace ID {
@@ -21,6 +21,7 @@ PARAMETER_ID (mix)
 PARAMETER_ID (in_level)
 PARAMETER_ID (out_level)
 PARAMETER_ID (freeze)
+PARAMETER_ID (interp)
 
 
 // tree taps:1-4:params
@@ -33,6 +34,8 @@ PARAMETER_ID (feedback)
 PARAMETER_ID (lpf)
 PARAMETER_ID (hpf)
 PARAMETER_ID (noise)
+PARAMETER_ID (sync)
+PARAMETER_ID (tapsync)
 
 
 #undef PARAMETER_ID
@@ -47,7 +50,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -66,6 +69,7 @@ public:
         I_TIME_2_TB,
         I_TIME_2_TC,
         I_TIME_2_TD,
+        I_CLK,
         I_MAX
     };
     enum {
@@ -97,6 +101,7 @@ public:
         Parameter &lpf;
         Parameter &hpf;
         Parameter &noise;
+        Parameter &sync;
     };
 
     struct PluginParams {
@@ -108,6 +113,7 @@ public:
         Parameter &in_level;
         Parameter &out_level;
         Parameter &freeze;
+        Parameter &interp;
 
         std::vector<std::unique_ptr<Tap>> taps_;
     } params_;
@@ -130,10 +136,10 @@ public:
     }
 
     void getRMS(float &lIn, float &rIn, float &lOut, float &rOut) {
-        lIn = inRms_[0].lvl();
-        rIn = inRms_[1].lvl();
-        lOut = outRms_[0].lvl();
-        rOut = outRms_[1].lvl();
+        lIn = inputLevel(I_IN_1).peak;
+        rIn = inputLevel(I_IN_2).peak;
+        lOut = outputLevel(O_OUT_1).peak;
+        rOut = outputLevel(O_OUT_2).peak;
     }
 
 
@@ -151,20 +157,43 @@ private:
     inline float normValue(RangedAudioParameter &p) { return p.convertFrom0to1(p.getValue()); }
 
 
-    // initial time with delay line from daisysp
     static constexpr unsigned MAX_DELAY = 48000 * 60; // 60 seconds
     static constexpr unsigned N_DLY_LINES = 2;
+    using line_type = TapDelayLine<MAX_DELAY>;
+    static_assert(line_type::N_TAPS == MAX_TAPS, "taps are processed as float4 lanes");
+
     struct DelayLine {
-        daisysp::DelayLine<float, MAX_DELAY> line_;
-        struct Taps {
-            daisysp::Tone lpf_;
-            daisysp::ATone hpf_;
-            daisysp::Dust noise_;
-        } taps_[MAX_TAPS];
+        line_type line_;
+        TapFilters filters_;
+        daisysp::Dust noise_[MAX_TAPS];
     } delayLines_[N_DLY_LINES];
 
-    ssp::RmsTrack inRms_[2];
-    ssp::RmsTrack outRms_[2];
+    template<line_type::Interp I>
+    void processLines(AudioSampleBuffer &buffer, float inlvl, float outlvl, float mix, float maxtime);
+
+    struct TapValues {
+        alignas(16) float time_[MAX_TAPS];
+        alignas(16) float level_[MAX_TAPS]; // includes pan
+        alignas(16) float feedback_[MAX_TAPS];
+        float noiseamt_[MAX_TAPS];
+        bool noise_ = false; // any tap using noise
+
+        // tap time (samples), synced taps crossfade from prev to cur when tempo changes
+        alignas(16) float cur_[MAX_TAPS];
+        alignas(16) float prev_[MAX_TAPS];
+        alignas(16) float upper_[MAX_TAPS];
+        float fade_ = 1.0f;
+        bool fading_ = false;
+    } tapValues_[N_DLY_LINES];
+
+    // clock input, period measured in samples (as clkd)
+    void processClock(AudioSampleBuffer &buffer);
+    static constexpr float CLK_TRIG_LEVEL = 0.5f;
+    static constexpr float XFADE_TIME = 0.05f; // seconds
+    float lastClkCv_ = 0.0f;
+    unsigned clkSampleCount_ = 0;
+    unsigned clkPeriod_ = 0; // 0 = no clock yet
+    float fadeInc_ = 1.0f;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "ssp/Float4.h"
+
+#include <cstring>
+
+// delay line with 4 read taps processed as lanes of a float4
+// indexing follows daisysp::DelayLine, write pointer moves backwards, so read(1) is the last sample written
+template<size_t max_size>
+class TapDelayLine {
+public:
+    static constexpr unsigned N_TAPS = ssp::float4::N;
+
+    enum Interp {
+        I_LINEAR,
+        I_HERMITE,
+        I_ALLPASS,
+        I_MAX
+    };
+
+    void Init() {
+        memset(line_, 0, sizeof(line_));
+        for (auto &ap: apState_) ap = ssp::float4::dup(0.0f);
+        writePtr_ = 0;
+    }
+
+    inline void Write(float sample) {
+        line_[writePtr_] = sample;
+        writePtr_ = writePtr_ == 0 ? max_size - 1 : writePtr_ - 1;
+    }
+
+    static constexpr unsigned N_READERS = 2;
+
+    // delay in samples, per tap
+    // reader allows more than one read per sample (e.g. crossfades), each has its own allpass state
+    template<Interp I>
+    inline ssp::float4 Read(const ssp::float4 &delay, unsigned reader = 0) {
+        // hermite reads one sample before and two after the integral delay
+        const float minDelay = I == I_HERMITE ? 2.0f : 1.0f;
+        ssp::float4 d = ssp::float4::clamp(delay, ssp::float4::dup(minDelay), ssp::float4::dup(float(max_size - 3)));
+        alignas(16) int32_t di[N_TAPS];
+        d.toInt(di);
+        ssp::float4 frac = d - ssp::float4::fromInt(di);
+
+        alignas(16) float xm1[N_TAPS], x0[N_TAPS], x1[N_TAPS], x2[N_TAPS];
+        for (unsigned t = 0; t < N_TAPS; t++) {
+            size_t p = wrap(writePtr_ + di[t]);
+            x0[t] = line_[p];
+            x1[t] = line_[wrap(p + 1)];
+            if (I == I_HERMITE) {
+                xm1[t] = line_[p == 0 ? max_size - 1 : p - 1];
+                x2[t] = line_[wrap(p + 2)];
+            }
+        }
+
+        ssp::float4 v0 = ssp::float4::load(x0);
+        ssp::float4 v1 = ssp::float4::load(x1);
+        switch (I) {
+            case I_HERMITE : {
+                // 4-point, 3rd-order hermite (x-form), as daisysp::DelayLine::ReadHermite
+                const ssp::float4 half = ssp::float4::dup(0.5f);
+                ssp::float4 vm1 = ssp::float4::load(xm1);
+                ssp::float4 v2 = ssp::float4::load(x2);
+                ssp::float4 c = (v1 - vm1) * half;
+                ssp::float4 v = v0 - v1;
+                ssp::float4 w = c + v;
+                ssp::float4 a = ssp::float4::madd(w + v, v2 - v0, half);
+                ssp::float4 bneg = w + a;
+                return ssp::float4::madd(v0, ((a * frac) - bneg) * frac + c, frac);
+            }
+            case I_ALLPASS : {
+                // first order allpass, y = x1 + n * (x0 - y[-1]) , n = (1 - frac) / (1 + frac)
+                const ssp::float4 one = ssp::float4::dup(1.0f);
+                ssp::float4 eta = (one - frac) * ssp::float4::recip(one + frac);
+                ssp::float4 &ap = apState_[reader];
+                ssp::float4 y = ssp::float4::madd(v1, eta, v0 - ap);
+                ap = y;
+                return y;
+            }
+            case I_LINEAR :
+            default: {
+                return ssp::float4::madd(v0, v1 - v0, frac);
+            }
+        }
+    }
+
+private:
+    static inline size_t wrap(size_t p) { return p >= max_size ? p - max_size : p; }
+
+    float line_[max_size];
+    size_t writePtr_ = 0;
+    ssp::float4 apState_[N_READERS];
+};
+
+
+// one pole filters, as daisysp Tone (lpf) and ATone (hpf), with each tap as a lane
+class TapFilters {
+public:
+    static constexpr unsigned N_TAPS = ssp::float4::N;
+
+    void Init(float sampleRate) {
+        sampleRate_ = sampleRate;
+        for (unsigned t = 0; t < N_TAPS; t++) {
+            lpfFreq_[t] = -1.0f;
+            hpfFreq_[t] = -1.0f;
+        }
+        memset(lpfC1_, 0, sizeof(lpfC1_));
+        memset(lpfC2_, 0, sizeof(lpfC2_));
+        memset(hpfC2_, 0, sizeof(hpfC2_));
+        memset(hpfBypass_, 0, sizeof(hpfBypass_));
+        lpfPrev_ = ssp::float4::dup(0.0f);
+        hpfPrevIn_ = ssp::float4::dup(0.0f);
+        hpfPrevOut_ = ssp::float4::dup(0.0f);
+        lpfActive_ = hpfActive_ = false;
+    }
+
+    // frequencies at or beyond these are treated as neutral, and the stage bypassed
+    static constexpr float LPF_OPEN = 20000.0f;
+    static constexpr float HPF_OPEN = 5.0f;
+
+    void SetFreq(unsigned t, float lpf, float hpf) {
+        if (lpf != lpfFreq_[t]) {
+            lpfFreq_[t] = lpf;
+            if (lpf >= LPF_OPEN) {
+                // neutral, out = in
+                lpfC1_[t] = 1.0f;
+                lpfC2_[t] = 0.0f;
+            } else {
+                float c2 = coeff(lpf);
+                lpfC1_[t] = 1.0f - c2;
+                lpfC2_[t] = c2;
+            }
+        }
+        if (hpf != hpfFreq_[t]) {
+            hpfFreq_[t] = hpf;
+            hpfBypass_[t] = hpf <= HPF_OPEN ? 0xFFFFFFFF : 0;
+            hpfC2_[t] = coeff(hpf);
+        }
+    }
+
+    // call after all taps frequencies are set
+    void Update() {
+        lpfActive_ = hpfActive_ = false;
+        for (unsigned t = 0; t < N_TAPS; t++) {
+            lpfActive_ |= lpfFreq_[t] < LPF_OPEN;
+            hpfActive_ |= hpfBypass_[t] == 0;
+        }
+        lc1_ = ssp::float4::load(lpfC1_);
+        lc2_ = ssp::float4::load(lpfC2_);
+        hc2_ = ssp::float4::load(hpfC2_);
+    }
+
+    inline ssp::float4 Process(const ssp::float4 &in) {
+        ssp::float4 v = in;
+        if (lpfActive_) {
+            v = (lc1_ * v) + (lc2_ * lpfPrev_);
+            lpfPrev_ = v;
+        }
+        if (hpfActive_) {
+            ssp::float4 out = hc2_ * (hpfPrevOut_ + v - hpfPrevIn_);
+            // bypassed taps keep state in step, so there is no jump when re-enabled
+            out = ssp::float4::select(hpfBypass_, v, out);
+            hpfPrevOut_ = out;
+            hpfPrevIn_ = v;
+            v = out;
+        }
+        return v;
+    }
+
+private:
+    float coeff(float freq) {
+        float b = 2.0f - cosf(2.0f * float(M_PI) * freq / sampleRate_);
+        return b - sqrtf(b * b - 1.0f);
+    }
+
+    float sampleRate_ = 48000.0f;
+
+    float lpfFreq_[N_TAPS];
+    float hpfFreq_[N_TAPS];
+    alignas(16) float lpfC1_[N_TAPS];
+    alignas(16) float lpfC2_[N_TAPS];
+    alignas(16) float hpfC2_[N_TAPS];
+    alignas(16) uint32_t hpfBypass_[N_TAPS];
+
+    bool lpfActive_ = false;
+    bool hpfActive_ = false;
+    ssp::float4 lc1_, lc2_, hc2_;
+    ssp::float4 lpfPrev_, hpfPrevIn_, hpfPrevOut_;
+};
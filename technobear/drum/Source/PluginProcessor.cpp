@@ -14,6 +14,7 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
     init();
+    for (unsigned i = 0; i < O_MAX; i++) fadeOnStateLoad(i);
 }
 
 PluginProcessor::~PluginProcessor() {
@@ -205,7 +206,7 @@ void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPe
     hiHat2_.Init(newSampleRate);
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned sz = buffer.getNumSamples();
     static constexpr float trigLevel = 0.2f;
     for (unsigned s = 0; s < sz; s++) {
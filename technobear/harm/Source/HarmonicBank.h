@@ -0,0 +1,226 @@
+#pragma once
+
+#include "ssp/Float4.h"
+
+#include <algorithm>
+
+// additive oscillator, partials processed as lanes of a float4
+// follows daisysp::HarmonicOscillator (first harmonic, attenuation towards nyquist)
+// but amplitudes are ramped per sample, and the number of partials can be changed
+template<unsigned MAX_PARTIALS>
+class HarmonicBank {
+public:
+    static constexpr unsigned N_LANES = ssp::float4::N;
+    static constexpr unsigned MAX_GROUPS = MAX_PARTIALS / N_LANES;
+    static_assert(MAX_PARTIALS % N_LANES == 0, "partials are processed as float4 lanes");
+
+    void Init(float sampleRate) {
+        sampleRate_ = sampleRate;
+        phase_ = 0.0f;
+        inc_ = 0.0f;
+        nGroups_ = MAX_GROUPS;
+        activeGroups_ = 0;
+        rampCnt_ = 0;
+        for (unsigned i = 0; i < MAX_PARTIALS; i++) {
+            amp_[i] = 0.0f;
+            dAmp_[i] = 0.0f;
+        }
+        SetFirstHarmIdx(1);
+    }
+
+    void SetFreq(float freq) { inc_ = std::min(std::max(freq / sampleRate_, 0.0f), 0.5f); }
+
+    void SetFirstHarmIdx(unsigned idx) {
+        first_ = std::max(idx, 1u);
+        alignas(16) float k[N_LANES];
+        for (unsigned l = 0; l < N_LANES; l++) k[l] = float(first_ + l);
+        kFirst_ = ssp::float4::load(k);
+    }
+
+    void SetPartials(unsigned n) { nGroups_ = std::min(std::max(n / N_LANES, 1u), MAX_GROUPS); }
+
+    unsigned GetPartials() const { return nGroups_ * N_LANES; }
+
+    // target amplitudes (GetPartials() values), reached linearly over rampSamples
+    // call after SetFreq and SetFirstHarmIdx, as partials are attenuated towards nyquist
+    void SetAmplitudes(const float *amps, unsigned rampSamples) {
+        const ssp::float4 zero = ssp::float4::dup(0.0f);
+        const ssp::float4 one = ssp::float4::dup(1.0f);
+        const ssp::float4 half = ssp::float4::dup(0.5f);
+        const ssp::float4 two = ssp::float4::dup(2.0f);
+        const ssp::float4 inc = ssp::float4::dup(inc_);
+        const ssp::float4 rRamp = ssp::float4::dup(1.0f / float(std::max(rampSamples, 1u)));
+
+        unsigned active = 0;
+        for (unsigned g = 0; g < MAX_GROUPS; g++) {
+            const unsigned o = g * N_LANES;
+            ssp::float4 target = zero;
+            if (g < nGroups_) {
+                ssp::float4 k = kFirst_ + ssp::float4::dup(float(o));
+                ssp::float4 f = ssp::float4::min(k * inc, half);
+                target = ssp::float4::load(amps + o) * (one - (f * two));
+            }
+            ssp::float4 cur = ssp::float4::load(amp_ + o);
+            ((target - cur) * rRamp).store(dAmp_ + o);
+
+            // a group is rendered while it, or its target, is audible
+            if ((ssp::float4::abs(target) + ssp::float4::abs(cur)).hsum() > 0.0f) active = g + 1;
+        }
+        activeGroups_ = active;
+        rampCnt_ = rampSamples;
+    }
+
+    inline float Process() {
+        phase_ += inc_;
+        if (phase_ >= 1.0f) phase_ -= 1.0f;
+
+        const bool ramping = rampCnt_ > 0;
+        if (ramping) rampCnt_--;
+        if (activeGroups_ == 0) return 0.0f;
+
+        // sin(k x) for the first group, and the 4 partials below it to start the recurrence
+        // sin((k + 4) x) = 2 cos(4 x) sin(k x) - sin((k - 4) x)
+        const ssp::float4 four = ssp::float4::dup(4.0f);
+        const ssp::float4 p = ssp::float4::dup(phase_);
+        ssp::float4 cur = ssp::float4::sin2pi(p * kFirst_);
+        ssp::float4 prev = ssp::float4::sin2pi(p * (kFirst_ - four));
+        const ssp::float4 c4 = ssp::float4::dup(2.0f) * ssp::float4::cos2pi(p * four);
+
+        ssp::float4 sum = ssp::float4::dup(0.0f);
+        for (unsigned g = 0; g < activeGroups_; g++) {
+            const unsigned o = g * N_LANES;
+            ssp::float4 a = ssp::float4::load(amp_ + o);
+            if (ramping) {
+                a += ssp::float4::load(dAmp_ + o);
+                a.store(amp_ + o);
+            }
+            sum = ssp::float4::madd(sum, a, cur);
+            ssp::float4 next = (c4 * cur) - prev;
+            prev = cur;
+            cur = next;
+        }
+        return sum.hsum();
+    }
+
+private:
+    float sampleRate_ = 48000.0f;
+    float phase_ = 0.0f;
+    float inc_ = 0.0f;
+    unsigned first_ = 1;
+    ssp::float4 kFirst_;
+    unsigned nGroups_ = MAX_GROUPS;
+    unsigned activeGroups_ = 0;
+    unsigned rampCnt_ = 0;
+
+    alignas(16) float amp_[MAX_PARTIALS];
+    alignas(16) float dAmp_[MAX_PARTIALS];
+};
+
+
+// additive oscillator voices, processed as lanes of a float4, sharing one set of partial amplitudes
+// each voice has its own frequency, so its own attenuation towards nyquist
+// the partials are summed with clenshaw's recurrence, rather than generating each sin(k x),
+// and amplitudes are ramped from the start of the ramp, rather than accumulated and stored
+// so each partial costs 2 loads and 3 float4 ops, for all 4 voices
+template<unsigned MAX_PARTIALS>
+class HarmonicVoices {
+public:
+    static constexpr unsigned N_VOICES = ssp::float4::N;
+
+    void Init(float sampleRate) {
+        sampleRate_ = sampleRate;
+        phase_ = ssp::float4::dup(0.0f);
+        for (unsigned v = 0; v < N_VOICES; v++) inc_[v] = 0.0f;
+        nPartials_ = MAX_PARTIALS;
+        activePartials_ = 0;
+        rampPos_ = 0;
+        rampLen_ = 0;
+        for (unsigned i = 0; i < MAX_PARTIALS * N_VOICES; i++) {
+            amp_[i] = 0.0f;
+            dAmp_[i] = 0.0f;
+        }
+        SetFirstHarmIdx(1);
+    }
+
+    void SetFreq(unsigned v, float freq) { inc_[v] = std::min(std::max(freq / sampleRate_, 0.0f), 0.5f); }
+
+    void SetFirstHarmIdx(unsigned idx) { first_ = std::max(idx, 1u); }
+
+    void SetPartials(unsigned n) { nPartials_ = std::min(std::max(n, 1u), MAX_PARTIALS); }
+
+    // target amplitudes (nPartials values, shared by all voices), reached linearly over rampSamples
+    // call after SetFreq and SetFirstHarmIdx, as partials are attenuated towards nyquist
+    void SetAmplitudes(const float *amps, unsigned rampSamples) {
+        const ssp::float4 zero = ssp::float4::dup(0.0f);
+        const ssp::float4 one = ssp::float4::dup(1.0f);
+        const ssp::float4 half = ssp::float4::dup(0.5f);
+        const ssp::float4 two = ssp::float4::dup(2.0f);
+        const ssp::float4 inc = ssp::float4::load(inc_);
+        const ssp::float4 pos = ssp::float4::dup(float(rampPos_));
+        const ssp::float4 rRamp = ssp::float4::dup(1.0f / float(std::max(rampSamples, 1u)));
+
+        unsigned active = 0;
+        for (unsigned h = 0; h < MAX_PARTIALS; h++) {
+            float *amp = amp_ + (h * N_VOICES);
+            float *dAmp = dAmp_ + (h * N_VOICES);
+            ssp::float4 target = zero;
+            if (h < nPartials_) {
+                ssp::float4 f = ssp::float4::min(ssp::float4::dup(float(first_ + h)) * inc, half);
+                target = ssp::float4::dup(amps[h]) * (one - (f * two));
+            }
+            // where the last ramp got to, is the start of this one
+            ssp::float4 cur = ssp::float4::madd(ssp::float4::load(amp), ssp::float4::load(dAmp), pos);
+            cur.store(amp);
+            ((target - cur) * rRamp).store(dAmp);
+
+            // a partial is rendered while it, or its target, is audible on any voice
+            if ((ssp::float4::abs(target) + ssp::float4::abs(cur)).hsum() > 0.0f) active = h + 1;
+        }
+        activePartials_ = active;
+        rampPos_ = 0;
+        rampLen_ = rampSamples;
+    }
+
+    // returns a sample for each voice
+    inline ssp::float4 Process() {
+        phase_ += ssp::float4::load(inc_);
+        phase_ = phase_ - ssp::float4::floor(phase_);
+
+        if (rampPos_ < rampLen_) rampPos_++;
+        if (activePartials_ == 0) return ssp::float4::dup(0.0f);
+
+        // sum a_h sin((first + h) x), using sin((k + 1) x) = 2 cos(x) sin(k x) - sin((k - 1) x)
+        // b_h = a_h + 2 cos(x) b_h+1 - b_h+2, sum = sin(first x) b_0 - sin((first - 1) x) b_1
+        const ssp::float4 k = ssp::float4::dup(float(first_));
+        const ssp::float4 c1 = ssp::float4::dup(2.0f) * ssp::float4::cos2pi(phase_);
+        const ssp::float4 pos = ssp::float4::dup(float(rampPos_));
+
+        ssp::float4 b1 = ssp::float4::dup(0.0f);
+        ssp::float4 b2 = b1;
+        for (unsigned h = activePartials_; h-- > 0;) {
+            const unsigned o = h * N_VOICES;
+            ssp::float4 a = ssp::float4::madd(ssp::float4::load(amp_ + o), ssp::float4::load(dAmp_ + o), pos);
+            ssp::float4 b = ssp::float4::madd(a - b2, c1, b1);
+            b2 = b1;
+            b1 = b;
+        }
+        ssp::float4 cur = ssp::float4::sin2pi(phase_ * k);
+        ssp::float4 prev = ssp::float4::sin2pi(phase_ * (k - ssp::float4::dup(1.0f)));
+        return (cur * b1) - (prev * b2);
+    }
+
+private:
+    float sampleRate_ = 48000.0f;
+    ssp::float4 phase_;
+    alignas(16) float inc_[N_VOICES];
+    unsigned first_ = 1;
+    unsigned nPartials_ = MAX_PARTIALS;
+    unsigned activePartials_ = 0;
+    unsigned rampPos_ = 0;
+    unsigned rampLen_ = 0;
+
+    // partial major, voices interleaved
+    // amplitude at rampPos_ is amp_ + rampPos_ * dAmp_
+    alignas(16) float amp_[MAX_PARTIALS * N_VOICES];
+    alignas(16) float dAmp_[MAX_PARTIALS * N_VOICES];
+};
@@ -23,8 +23,8 @@ PluginEditor::PluginEditor(PluginProcessor &p)
     addParamPage(
         std::make_shared<pcontrol_type>(processor_.params_.pitch, 1.0f, 0.01),
         std::make_shared<pcontrol_type>(processor_.params_.first, 1.0f, 1.0f),
-        nullptr,
-        nullptr,
+        std::make_shared<pcontrol_type>(processor_.params_.partials, 1.0f, 1.0f),
+        std::make_shared<pcontrol_type>(processor_.params_.voices, 1.0f, 1.0f),
         view,
         Colours::orange
     );
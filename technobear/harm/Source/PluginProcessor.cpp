@@ -2,10 +2,6 @@
 #include "PluginEditor.h"
 #include "ssp/EditorHost.h"
 
-inline float constrain(float v, float vMin, float vMax) {
-    return std::max<float>(vMin, std::min<float>(vMax, v));
-}
-
 PluginProcessor::PluginProcessor()
     : PluginProcessor(getBusesProperties(), createParameterLayout()) {}
 
@@ -14,6 +10,7 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
     init();
+    fadeOnStateLoad(O_MAIN);
 }
 
 PluginProcessor::~PluginProcessor() {
@@ -38,7 +35,9 @@ PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt)
     first(*apvt.getParameter(ID::first)),
     centre(*apvt.getParameter(ID::centre)),
     spread(*apvt.getParameter(ID::spread)),
-    amount(*apvt.getParameter(ID::amount)) {
+    amount(*apvt.getParameter(ID::amount)),
+    partials(*apvt.getParameter(ID::partials)),
+    voices(*apvt.getParameter(ID::voices)) {
     for (unsigned hid = 0; hid < MAX_HARMONICS; hid++) {
         auto harmonic = std::make_unique<Harmonic>(apvt, hid);
         harmonics_.push_back(std::move(harmonic));
@@ -64,6 +63,10 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     }
     params.add(std::move(harmonics));
 
+    // added after harmonics, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::partials, "Partials", StringArray{"16", "32", "64"}, 0));
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::voices, "Voices", StringArray{"1", "2", "3", "4"}, 0));
+
     return params;
 }
 
@@ -74,7 +77,13 @@ const String PluginProcessor::getInputBusName(int channelIndex) {
         "Amp",
         "TCentre",
         "TSpread",
-        "TAmount"
+        "TAmount",
+        "VOct 2",
+        "Amp 2",
+        "VOct 3",
+        "Amp 3",
+        "VOct 4",
+        "Amp 4"
     };
     if (channelIndex < I_MAX) { return inBusName[channelIndex]; }
     return "ZZIn-" + String(channelIndex);
@@ -93,57 +102,130 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPerBlock) {
     BaseProcessor::prepareToPlay(newSampleRate, estimatedSamplesPerBlock);
     oscillator_.Init(newSampleRate);
+    voices_.Init(newSampleRate);
+    for (unsigned h = 0; h < MAX_PARTIALS; h++) {
+        harmonicAmps_[h] = 0.0f;
+    }
+}
+
+
+void PluginProcessor::computeAmplitudes(float centre, float spread, float amount, unsigned partials, float *amps) {
+    // tilt is a raised cosine window over the partials, centre/spread are in terms of 16 harmonics
+    // so more partials stretch the same shape over a wider range
+    const float rPartials = 1.0f / float(partials);
+    const float hspread = spread / 8.0f;
+    const ssp::float4 offset = ssp::float4::dup(centre * float(partials) / float(MAX_HARMONICS));
+    const ssp::float4 scale = ssp::float4::dup(rPartials / hspread);
+    const ssp::float4 vamount = ssp::float4::dup(amount);
+    const ssp::float4 lo = ssp::float4::dup(-1.0f);
+    const ssp::float4 hi = ssp::float4::dup(1.0f);
+    const ssp::float4 half = ssp::float4::dup(0.5f);
+    const ssp::float4 zero = ssp::float4::dup(0.0f);
+    alignas(16) static const float lanes[ssp::float4::N] = {0.0f, 1.0f, 2.0f, 3.0f};
+
+    ssp::float4 sum = zero;
+    for (unsigned h = 0; h < partials; h += ssp::float4::N) {
+        ssp::float4 ph = ssp::float4::load(lanes) + ssp::float4::dup(float(h)) + offset;
+        ssp::float4 tph = ssp::float4::clamp(ph * scale, lo, hi);
+        ssp::float4 tilt = ssp::float4::max(ssp::float4::cos2pi(tph * half), zero);
+        ssp::float4 a = ssp::float4::madd(ssp::float4::load(harmonicAmps_ + h), tilt, vamount);
+        a.store(amps + h);
+        sum += a;
+    }
+
+    float total = sum.hsum();
+    float rsum = total > 0.0f ? 1.0f / total : 1.0f;
+    FloatVectorOperations::multiply(amps, rsum, partials);
 }
 
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned sz = buffer.getNumSamples();
 
     static constexpr float baseNote = 60.0f;
-    float pitch =
-        normValue(params_.pitch)
-        + cv2Pitch(buffer.getSample(I_VOCT, 0))
-        + baseNote;
-    float freq = daisysp::mtof(pitch);
-
-    oscillator_.SetFirstHarmIdx(normValue(params_.first));
-
-    // control rate
-    float cvCentre = (buffer.getSample(I_CENTRE, 0) * 8.0f) + 8.0f; // 0..16
-    float cvSpread = (buffer.getSample(I_SPREAD, 0) * 8.0f) + 8.0f; // 0..16
-    float cvAmount = buffer.getSample(I_AMOUNT, 0);
-    float centre = daisysp::fclamp((normValue(params_.centre) - 1.0f) + cvCentre, 0.0f, 16.0f) * -1.0f;
-    float spread = daisysp::fclamp(normValue(params_.spread) + cvSpread, 0.1, 16.0f);
-    float amount = daisysp::fclamp(params_.amount.getValue() + cvAmount, 0.0f, 1.0f);
-
-    float amps[MAX_HARMONICS];
-    float sum = 0.0f;
-    float hspread = spread / 8.0f;
-    static constexpr float rHarmonics = 1.0f / float(MAX_HARMONICS);
-    for (unsigned h = 0; h < MAX_HARMONICS; h++) {
-        auto &harmonic = *params_.harmonics_[h];
-        float ph = (h + centre) * rHarmonics;
-        float sph = (ph / hspread);
-        float tph = daisysp::fclamp(sph, -1.0f, 1.0f);
-        float tilt = daisysp::fmax(cosf(tph * PI_F), 0);
-        amps[h] = tilt * amount;
-        amps[h] += harmonic.amp.getValue(); // 0..1 is fine
-        sum += amps[h];
+    float pitch = normValue(params_.pitch) + baseNote;
+
+    unsigned partials = MAX_HARMONICS << unsigned(normValue(params_.partials));
+    unsigned firstHarm = unsigned(normValue(params_.first));
+    unsigned nVoices = 1 + unsigned(normValue(params_.voices));
+    bool poly = nVoices > 1;
+    if (poly != (nVoices_ > 1)) {
+        // switching engine, start from silence, amplitudes ramp in
+        if (poly) voices_.Init(getSampleRate());
+        else oscillator_.Init(getSampleRate());
+    }
+    nVoices_ = nVoices;
+    // voices are summed, keep level near mono
+    const float voiceGain = 1.0f / sqrtf(float(nVoices));
+
+    if (poly) {
+        voices_.SetPartials(partials);
+        voices_.SetFirstHarmIdx(firstHarm);
+    } else {
+        oscillator_.SetPartials(partials);
+        oscillator_.SetFirstHarmIdx(firstHarm);
     }
 
-
-    float rsum = sum > 0.0f ? 1.0f / sum : 1.0f;
     for (unsigned h = 0; h < MAX_HARMONICS; h++) {
-        amps[h] = amps[h] * rsum;
+        harmonicAmps_[h] = params_.harmonics_[h]->amp.getValue(); // 0..1 is fine
     }
 
-    oscillator_.SetFreq(freq);
-    oscillator_.SetAmplitudes(amps);
-
-    bool iAmp = isInputEnabled(I_AMP);
-    for (int s = 0; s < sz; s++) {
-        float amp = iAmp ? buffer.getSample(I_AMP, s) : 1.0f;
-        buffer.setSample(O_MAIN, s, oscillator_.Process() * amp);
+    float pCentre = normValue(params_.centre) - 1.0f;
+    float pSpread = normValue(params_.spread);
+    float pAmount = params_.amount.getValue();
+
+    static constexpr unsigned voctIn[MAX_VOICES] = {I_VOCT, I_VOCT_2, I_VOCT_3, I_VOCT_4};
+    static constexpr unsigned ampIn[MAX_VOICES] = {I_AMP, I_AMP_2, I_AMP_3, I_AMP_4};
+    const float *voct[MAX_VOICES];
+    const float *amp[MAX_VOICES];
+    bool iAmp[MAX_VOICES];
+    for (unsigned v = 0; v < MAX_VOICES; v++) {
+        voct[v] = buffer.getReadPointer(voctIn[v]);
+        amp[v] = buffer.getReadPointer(ampIn[v]);
+        iAmp[v] = isInputEnabled(ampIn[v]);
+    }
+    const float *centreIn = buffer.getReadPointer(I_CENTRE);
+    const float *spreadIn = buffer.getReadPointer(I_SPREAD);
+    const float *amountIn = buffer.getReadPointer(I_AMOUNT);
+    float *out = buffer.getWritePointer(O_MAIN);
+
+    alignas(16) float amps[MAX_PARTIALS];
+    for (unsigned s0 = 0; s0 < sz; s0 += SUB_BLOCK) {
+        unsigned n = std::min(SUB_BLOCK, sz - s0);
+
+        // control rate, note: voct shares its channel with main out, so read before writing
+        if (poly) {
+            for (unsigned v = 0; v < MAX_VOICES; v++) {
+                voices_.SetFreq(v, daisysp::mtof(pitch + cv2Pitch(voct[v][s0])));
+            }
+        } else {
+            oscillator_.SetFreq(daisysp::mtof(pitch + cv2Pitch(voct[0][s0])));
+        }
+
+        float cvCentre = (centreIn[s0] * 8.0f) + 8.0f; // 0..16
+        float cvSpread = (spreadIn[s0] * 8.0f) + 8.0f; // 0..16
+        float cvAmount = amountIn[s0];
+        float centre = daisysp::fclamp(pCentre + cvCentre, 0.0f, 16.0f) * -1.0f;
+        float spread = daisysp::fclamp(pSpread + cvSpread, 0.1, 16.0f);
+        float amount = daisysp::fclamp(pAmount + cvAmount, 0.0f, 1.0f);
+        computeAmplitudes(centre, spread, amount, partials, amps);
+
+        if (poly) {
+            voices_.SetAmplitudes(amps, n);
+            alignas(16) float gain[MAX_VOICES];
+            for (unsigned s = s0; s < s0 + n; s++) {
+                for (unsigned v = 0; v < MAX_VOICES; v++) {
+                    gain[v] = v < nVoices ? (iAmp[v] ? amp[v][s] : 1.0f) * voiceGain : 0.0f;
+                }
+                out[s] = (voices_.Process() * ssp::float4::load(gain)).hsum();
+            }
+        } else {
+            oscillator_.SetAmplitudes(amps, n);
+            for (unsigned s = s0; s < s0 + n; s++) {
+                float a = iAmp[0] ? amp[0][s] : 1.0f;
+                out[s] = oscillator_.Process() * a;
+            }
+        }
     }
 }
 
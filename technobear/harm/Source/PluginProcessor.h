@@ -9,6 +9,8 @@
 
 #include "daisysp.h"
 
+#include "HarmonicBank.h"
+
 namespace ID {
 #define PARAMETER_ID(str) constexpr const char* str { #str };
 constexpr const char *separator{":"};
@@ -24,6 +26,9 @@ PARAMETER_ID (amount)
 PARAMETER_ID(harmonics)
 // harmonics 1-16
 PARAMETER_ID (amp)
+
+PARAMETER_ID (partials)
+PARAMETER_ID (voices)
 #undef PARAMETER_ID
 }
 
@@ -36,7 +41,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -50,6 +55,12 @@ public:
         I_CENTRE,
         I_SPREAD,
         I_AMOUNT,
+        I_VOCT_2,
+        I_AMP_2,
+        I_VOCT_3,
+        I_AMP_3,
+        I_VOCT_4,
+        I_AMP_4,
         I_MAX
     };
     enum {
@@ -58,6 +69,8 @@ public:
     };
 
     static constexpr unsigned MAX_HARMONICS = 16;
+    static constexpr unsigned MAX_PARTIALS = 64;
+    static constexpr unsigned MAX_VOICES = HarmonicVoices<MAX_PARTIALS>::N_VOICES;
 
 
     struct Harmonic {
@@ -77,6 +90,8 @@ public:
         Parameter &spread;
         Parameter &amount;
         std::vector<std::unique_ptr<Harmonic>> harmonics_;
+        Parameter &partials;
+        Parameter &voices;
     } params_;
 
     Harmonic &getHarmonic(unsigned n) {
@@ -105,7 +120,16 @@ private:
     }
 
 
-    daisysp::HarmonicOscillator<MAX_HARMONICS> oscillator_;
+    // amplitudes (and pitch) are updated every sub block, and ramped per sample
+    static constexpr unsigned SUB_BLOCK = 8;
+
+    void computeAmplitudes(float centre, float spread, float amount, unsigned partials, float *amps);
+
+    // single voice renders partials across lanes, polyphony renders voices across lanes
+    HarmonicBank<MAX_PARTIALS> oscillator_;
+    HarmonicVoices<MAX_PARTIALS> voices_;
+    unsigned nVoices_ = 1;
+    alignas(16) float harmonicAmps_[MAX_PARTIALS];
 
     bool isBusesLayoutSupported(const BusesLayout &layouts) const override {
         return true;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ssp/Float4.h"
+
+#include <cmath>
+
+// 4 pole ladder lowpass, 4 filters processed as lanes of a float4
+// zero delay feedback (TPT) one pole stages, with a soft saturator on the feedback summing point
+// used for audio rate cv, it does not match the daisysp ladder used at block rate in resonance or drive
+class Ladder4 {
+public:
+    void Init(float sampleRate) {
+        invSampleRate_ = 1.0f / sampleRate;
+        for (unsigned i = 0; i <= TAN_TABLE_SIZE; i++) {
+            // covers normalised frequency 0 to MAX_NORM_FREQ
+            float fn = (float(i) / float(TAN_TABLE_SIZE)) * MAX_NORM_FREQ;
+            tanTable_[i] = tanf(float(M_PI) * fn);
+        }
+        Reset();
+    }
+
+    void Reset() {
+        for (auto &s: s_) s = ssp::float4::dup(0.0f);
+    }
+
+    // table based coefficient, for audio rate updates
+    ssp::float4 coeff(const ssp::float4 &freq) const {
+        static constexpr float scale = float(TAN_TABLE_SIZE) / MAX_NORM_FREQ;
+        ssp::float4 pos = ssp::float4::clamp(
+            freq * ssp::float4::dup(invSampleRate_ * scale),
+            ssp::float4::dup(0.0f),
+            ssp::float4::dup(float(TAN_TABLE_SIZE) - 0.001f));
+        alignas(16) int32_t idx[ssp::float4::N];
+        pos.toInt(idx);
+        ssp::float4 frac = pos - ssp::float4::fromInt(idx);
+        alignas(16) float t0[ssp::float4::N], t1[ssp::float4::N];
+        for (unsigned i = 0; i < ssp::float4::N; i++) {
+            t0[i] = tanTable_[idx[i]];
+            t1[i] = tanTable_[idx[i] + 1];
+        }
+        ssp::float4 a = ssp::float4::load(t0);
+        return ssp::float4::madd(a, ssp::float4::load(t1) - a, frac);
+    }
+
+    // g = coeff(cutoff), k = resonance feedback, 0-4 (self oscillates near 4)
+    inline ssp::float4 Process(const ssp::float4 &in, const ssp::float4 &g, const ssp::float4 &k) {
+        const ssp::float4 one = ssp::float4::dup(1.0f);
+        ssp::float4 G = g * ssp::float4::recip(one + g);
+        ssp::float4 sc = one - G; // 1 / (1+g)
+
+        // estimate output from current state, to resolve the feedback loop
+        ssp::float4 sigma = ssp::float4::madd(s_[1] * sc, s_[0] * sc, G);
+        sigma = ssp::float4::madd(s_[2] * sc, sigma, G);
+        sigma = ssp::float4::madd(s_[3] * sc, sigma, G);
+        ssp::float4 G2 = G * G;
+        ssp::float4 G4 = G2 * G2;
+        ssp::float4 y = ssp::float4::madd(sigma, G4, in) * ssp::float4::recip(ssp::float4::madd(one, k, G4));
+
+        ssp::float4 u = saturate(in - (k * y));
+        for (auto &s: s_) {
+            ssp::float4 v = (u - s) * G;
+            u = v + s;
+            s = u + v;
+        }
+        return u;
+    }
+
+private:
+    // rational tanh approximation, input limited to +/-3
+    static inline ssp::float4 saturate(const ssp::float4 &x) {
+        ssp::float4 c = ssp::float4::clamp(x, ssp::float4::dup(-3.0f), ssp::float4::dup(3.0f));
+        ssp::float4 c2 = c * c;
+        ssp::float4 n = c * (ssp::float4::dup(27.0f) + c2);
+        ssp::float4 d = ssp::float4::madd(ssp::float4::dup(27.0f), ssp::float4::dup(9.0f), c2);
+        return n * ssp::float4::recip(d);
+    }
+
+    static constexpr unsigned TAN_TABLE_SIZE = 1024;
+    static constexpr float MAX_NORM_FREQ = 0.45f;
+
+    float invSampleRate_ = 1.0f / 48000.0f;
+    float tanTable_[TAN_TABLE_SIZE + 1];
+    ssp::float4 s_[4];
+};
@@ -26,8 +26,8 @@ PluginEditor::PluginEditor(PluginProcessor &p)
     addParamPage(
         std::make_shared<pcontrol_type>(processor_.getFilter(f).cutoff, fltCoarse, fltFin),
         std::make_shared<pcontrol_type>(processor_.getFilter(f).res, 0.1, 0.01f),
-        nullptr,
-        nullptr,
+        std::make_shared<pcontrol_type>(processor_.params_.cvrate, 1.0f, 1.0f),
+        std::make_shared<pcontrol_type>(processor_.params_.routing, 1.0f, 1.0f),
         view,
         clrs[f % L_CLRS]
     );
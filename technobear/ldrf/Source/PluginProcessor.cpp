@@ -17,6 +17,7 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
     init();
+    for (unsigned i = 0; i < O_MAX; i++) fadeOnStateLoad(i);
     for (unsigned i = 0; i < MAX_FILTERS; i++) {
         filters_.push_back(std::make_unique<daisysp::MoogLadder>());
     }
@@ -45,7 +46,9 @@ PluginProcessor::Filter::Filter(AudioProcessorValueTreeState &apvt, unsigned id)
     res(*apvt.getParameter(getResPid(id))) {
 }
 
-PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt) {
+PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt) :
+    cvrate(*apvt.getParameter(ID::cvrate)),
+    routing(*apvt.getParameter(ID::routing)) {
     for (unsigned id = 0; id < MAX_FILTERS; id++) {
         auto filter = std::make_unique<Filter>(apvt, id);
         filters_.push_back(std::move(filter));
@@ -68,6 +71,20 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     }
     params.add(std::move(harmonics));
 
+    // added after filters, to keep parameter indexes (used by midi automation) stable
+    StringArray cvrates;
+    cvrates.add("Block");
+    cvrates.add("Audio");
+    jassert(cvrates.size() == CV_MAX);
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::cvrate, "CV Rate", cvrates, CV_BLOCK));
+
+    StringArray routings;
+    routings.add("Indep");
+    routings.add("Cascade");
+    routings.add("Parallel");
+    jassert(routings.size() == R_MAX);
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::routing, "Routing", routings, R_INDEPENDENT));
+
     return params;
 }
 
@@ -109,51 +126,107 @@ void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPe
     for (auto &filter: filters_) {
         filter->Init(newSampleRate);
     }
+    ladder_.Init(newSampleRate);
+    for (auto &o: lastOut_) o = 0.0f;
 }
 
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned sz = buffer.getNumSamples();
-
-//    static constexpr float baseNote = 60.0f;
-//    float pitch =
-//        normValue(params_.pitch)
-//        + cv2Pitch(buffer.getSample(I_VOCT, 0))
-//        + baseNote;
-//    float freq = daisysp::mtof(pitch);
     static unsigned constexpr IN_MULT = I_IN_2 - I_IN_1;
 
-    float cutoff[MAX_FILTERS];
-    float res[MAX_FILTERS];
+    bool anyOut = false;
+    for (unsigned f = 0; f < MAX_FILTERS; f++) {
+        anyOut |= isOutputEnabled(O_OUT_1 + f);
+    }
+    if (!anyOut) return;
+
+    const bool audioRate = CvRate(int(normValue(params_.cvrate))) == CV_AUDIO;
+    const Routing routing = Routing(int(normValue(params_.routing)));
+
+    alignas(16) float pCutoff[MAX_FILTERS];
+    alignas(16) float pRes[MAX_FILTERS];
+    const float *in[MAX_FILTERS];
+    const float *cvCutoff[MAX_FILTERS];
+    const float *cvRes[MAX_FILTERS];
+    float *out[MAX_FILTERS];
+    bool inEnabled[MAX_FILTERS];
+    bool outEnabled[MAX_FILTERS];
 
     for (unsigned f = 0; f < MAX_FILTERS; f++) {
-        float cvCutoff = buffer.getSample((f * IN_MULT) + I_CUTOFF_1, 0) * MAX_CUTOFF_FREQ;
-        float cvRes = buffer.getSample((f * IN_MULT) + I_RES_1, 0);
+        pCutoff[f] = normValue(params_.filters_[f]->cutoff);
+        pRes[f] = normValue(params_.filters_[f]->res);
+        in[f] = buffer.getReadPointer((f * IN_MULT) + I_IN_1);
+        cvCutoff[f] = buffer.getReadPointer((f * IN_MULT) + I_CUTOFF_1);
+        cvRes[f] = buffer.getReadPointer((f * IN_MULT) + I_RES_1);
+        // note: outputs share channels with inputs, all inputs are read for a sample before outputs are written
+        out[f] = buffer.getWritePointer(O_OUT_1 + f);
+        inEnabled[f] = routing == R_INDEPENDENT || f == 0 || isInputEnabled((f * IN_MULT) + I_IN_1);
+        outEnabled[f] = isOutputEnabled(O_OUT_1 + f);
+    }
 
-        float pCutoff = normValue(params_.filters_[f]->cutoff);
-        float pRes = normValue(params_.filters_[f]->res);
-        cutoff[f] = daisysp::fclamp(cvCutoff + pCutoff, MIN_CUTOFF_FREQ, MAX_CUTOFF_FREQ);
-        res[f] = daisysp::fclamp(cvRes + pRes, 0.0f, 1.0f);
+    // block rate filters are run when their output is used
+    // directly, or in cascade as the input to the next filter
+    bool needed[MAX_FILTERS];
+    for (unsigned f = MAX_FILTERS; f-- > 0;) {
+        const bool feedsNext = routing == R_CASCADE && f + 1 < MAX_FILTERS && !inEnabled[f + 1] && needed[f + 1];
+        needed[f] = outEnabled[f] || feedsNext;
+    }
 
-        if (isOutputEnabled(O_OUT_1 + f)) {
-            filters_[f]->SetFreq(cutoff[f]);
-            filters_[f]->SetRes(res[f]);
+    const ssp::float4 zero = ssp::float4::dup(0.0f);
+    const ssp::float4 one = ssp::float4::dup(1.0f);
+    const ssp::float4 four = ssp::float4::dup(4.0f);
+    const ssp::float4 minCutoff = ssp::float4::dup(MIN_CUTOFF_FREQ);
+    const ssp::float4 maxCutoff = ssp::float4::dup(MAX_CUTOFF_FREQ);
+    const ssp::float4 paramCutoff = ssp::float4::load(pCutoff);
+    const ssp::float4 paramRes = ssp::float4::load(pRes);
+
+    float blockComp[MAX_FILTERS];
+    if (!audioRate) {
+        // control rate, cv sampled at start of block, original ladder so existing patches sound the same
+        for (unsigned f = 0; f < MAX_FILTERS; f++) {
+            float cutoff = daisysp::fclamp(cvCutoff[f][0] * MAX_CUTOFF_FREQ + pCutoff[f], MIN_CUTOFF_FREQ, MAX_CUTOFF_FREQ);
+            float res = daisysp::fclamp(cvRes[f][0] + pRes[f], 0.0f, 1.0f);
+            filters_[f]->SetFreq(cutoff);
+            filters_[f]->SetRes(res);
+            float compensation = 1 + res;
+            blockComp[f] = compensation * compensation;
         }
     }
 
+    for (unsigned s = 0; s < sz; s++) {
+        alignas(16) float x[MAX_FILTERS];
+        for (unsigned f = 0; f < MAX_FILTERS; f++) {
+            if (inEnabled[f]) {
+                x[f] = in[f][s];
+            } else if (routing == R_CASCADE) {
+                // previous filters output, from last sample
+                x[f] = lastOut_[f - 1];
+            } else {
+                x[f] = x[f - 1];
+            }
+        }
 
-    for (unsigned f = 0; f < MAX_FILTERS; f++) {
-        for (int s = 0; s < sz; s++) {
-            unsigned och = O_OUT_1 + f;
-            if (isOutputEnabled(och)) {
-                unsigned ich = (f * IN_MULT) + I_IN_1;
-                unsigned fch = ich;
-                // cascading, think about this optionally... since we want to optimise when we dont use
-                //            unsigned fch = (f == 0 || isInputEnabled(ich)) ? ich : och - 1;
-                float in = buffer.getSample(fch, s);
-                float compensation = 1 + (res[f]);
-                buffer.setSample(och, s, filters_[f]->Process(in) * (compensation * compensation));
+        if (!audioRate) {
+            for (unsigned f = 0; f < MAX_FILTERS; f++) {
+                if (needed[f]) lastOut_[f] = filters_[f]->Process(x[f]) * blockComp[f];
+            }
+        } else {
+            alignas(16) float cc[MAX_FILTERS];
+            alignas(16) float cr[MAX_FILTERS];
+            for (unsigned f = 0; f < MAX_FILTERS; f++) {
+                cc[f] = cvCutoff[f][s];
+                cr[f] = cvRes[f][s];
             }
+            ssp::float4 cutoff = ssp::float4::clamp(
+                ssp::float4::madd(paramCutoff, ssp::float4::load(cc), maxCutoff), minCutoff, maxCutoff);
+            ssp::float4 r = ssp::float4::clamp(paramRes + ssp::float4::load(cr), zero, one);
+            ssp::float4 comp = (one + r) * (one + r);
+            ssp::float4 y = ladder_.Process(ssp::float4::load(x), ladder_.coeff(cutoff), r * four) * comp;
+            y.store(lastOut_);
+        }
+        for (unsigned f = 0; f < MAX_FILTERS; f++) {
+            if (outEnabled[f]) out[f][s] = lastOut_[f];
         }
     }
 }
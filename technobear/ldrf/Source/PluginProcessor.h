@@ -8,6 +8,7 @@
 #include <algorithm>
 
 #include "daisysp.h"
+#include "Ladder4.h"
 
 namespace ID {
 #define PARAMETER_ID(str) constexpr const char* str { #str };
@@ -17,6 +18,8 @@ constexpr const char *separator{":"};
 PARAMETER_ID(filters)
 PARAMETER_ID (cutoff)
 PARAMETER_ID (res)
+PARAMETER_ID (cvrate)
+PARAMETER_ID (routing)
 #undef PARAMETER_ID
 }
 
@@ -29,7 +32,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -76,6 +79,8 @@ public:
         using Parameter = juce::RangedAudioParameter;
         explicit PluginParams(juce::AudioProcessorValueTreeState &);
         std::vector<std::unique_ptr<Filter>> filters_;
+        Parameter &cvrate;
+        Parameter &routing;
     } params_;
 
     Filter &getFilter(unsigned n) {
@@ -103,7 +108,25 @@ private:
         return p.convertFrom0to1(p.getValue());
     }
 
+    enum CvRate {
+        CV_BLOCK,
+        CV_AUDIO,
+        CV_MAX
+    };
+
+    // unpatched inputs take, none, output of previous filter, or input of previous filter
+    enum Routing {
+        R_INDEPENDENT,
+        R_CASCADE,
+        R_PARALLEL,
+        R_MAX
+    };
+
+    // block rate cv uses the original (daisysp) ladder, audio rate cv the 4 lane ladder
     std::vector<std::unique_ptr<daisysp::MoogLadder>> filters_;
+    static_assert(MAX_FILTERS == ssp::float4::N, "filters are processed as float4 lanes");
+    Ladder4 ladder_;
+    alignas(16) float lastOut_[MAX_FILTERS] = {0.0f, 0.0f, 0.0f, 0.0f};
 
     bool isBusesLayoutSupported(const BusesLayout &layouts) const override {
         return true;
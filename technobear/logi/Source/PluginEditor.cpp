@@ -18,7 +18,7 @@ PluginEditor::PluginEditor(PluginProcessor &p)
     addParamPage(
         std::make_shared<pcontrol_type>(processor_.params_.oper, 1.0f, 1.0f),
         std::make_shared<pcontrol_type>(processor_.params_.triglevel, 0.1, 0.01f),
-        nullptr,
+        std::make_shared<pcontrol_type>(processor_.params_.hysteresis, 0.05, 0.01f),
         nullptr
     );
 
@@ -2,6 +2,11 @@
 #include "PluginEditor.h"
 #include "ssp/EditorHost.h"
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LOGI_USE_NEON
+#endif
+
 
 PluginProcessor::PluginProcessor()
     : PluginProcessor(getBusesProperties(), createParameterLayout()) {}
@@ -27,7 +32,8 @@ PluginProcessor::GateParam::GateParam(AudioProcessorValueTreeState &apvt, String
 
 PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt) :
     oper(*apvt.getParameter(ID::oper)),
-    triglevel(*apvt.getParameter(ID::triglevel)) {
+    triglevel(*apvt.getParameter(ID::triglevel)),
+    hysteresis(*apvt.getParameter(ID::hysteresis)) {
     for (unsigned i = 0; i < I_MAX; i++) {
         gateparams_.push_back(std::make_unique<GateParam>(apvt, ID::gates, i));
     }
@@ -62,6 +68,8 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     }
     params.add(std::move(sg));
 
+    // added after gates, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::hysteresis, "Hysteresis", 0.0f, 0.5f, 0.0f));
 
     return params;
 }
@@ -110,118 +118,259 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 
 //TODO : could add buttons , which invert input?
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
-    static constexpr unsigned N_PAIRS = I_MAX / 2;
-    float trigLevel = normValue(params_.triglevel);
+// gate logic operates on masks, 0 = false, 0xFFFFFFFF = true
+// operator is selected once per block, by instantiating a kernel per operator
+
+static constexpr uint32_t M_TRUE = 0xFFFFFFFF;
+static constexpr uint32_t M_FALSE = 0x00000000;
+static constexpr uint32_t F_ONE = 0x3f800000; // 1.0f
+
+template<int OP>
+inline uint32_t pairOp(uint32_t a, uint32_t b) {
+    switch (OP) {
+        case 0 : return a & b; // AND
+        case 1 : return a | b; // OR
+        case 2 : return a ^ b; // XOR
+        case 3 : return ~(a & b); // NAND
+        case 4 : return ~(a ^ b); // NOR
+        case 5 : return ~a; // NOT A
+        case 6 : return ~b; // NOT B
+        default: return a; // GT/LT : comparator mask is passed in a
+    }
+}
+
+template<int OP>
+inline uint32_t allOp(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    switch (OP) {
+        case 0 : return a & b & c & d; // AND
+        case 1 : return a | b | c | d; // OR
+        case 2 : return (a ^ b) ^ (c ^ d); // XOR
+        case 3 : return ~(a & b & c & d); // NAND
+        case 4 : return ~((a ^ b) ^ (c ^ d)); // NOR
+        case 5 :
+        case 6 : return a & b & c & d; // NOT A, NOT B
+        case 7 : return ((a & 1) + (b & 1)) > ((c & 1) + (d & 1)) ? M_TRUE : M_FALSE; // GT
+        case 8 : return ((a & 1) + (b & 1)) < ((c & 1) + (d & 1)) ? M_TRUE : M_FALSE; // LT
+        default: return M_FALSE;
+    }
+}
+
+#ifdef LOGI_USE_NEON
+
+template<int OP>
+inline uint32x4_t pairOp(uint32x4_t a, uint32x4_t b) {
+    switch (OP) {
+        case 0 : return vandq_u32(a, b);
+        case 1 : return vorrq_u32(a, b);
+        case 2 : return veorq_u32(a, b);
+        case 3 : return vmvnq_u32(vandq_u32(a, b));
+        case 4 : return vmvnq_u32(veorq_u32(a, b));
+        case 5 : return vmvnq_u32(a);
+        case 6 : return vmvnq_u32(b);
+        default: return a;
+    }
+}
+
+template<int OP>
+inline uint32x4_t allOp(uint32x4_t a, uint32x4_t b, uint32x4_t c, uint32x4_t d) {
+    switch (OP) {
+        case 0 : return vandq_u32(vandq_u32(a, b), vandq_u32(c, d));
+        case 1 : return vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d));
+        case 2 : return veorq_u32(veorq_u32(a, b), veorq_u32(c, d));
+        case 3 : return vmvnq_u32(vandq_u32(vandq_u32(a, b), vandq_u32(c, d)));
+        case 4 : return vmvnq_u32(veorq_u32(veorq_u32(a, b), veorq_u32(c, d)));
+        case 5 :
+        case 6 : return vandq_u32(vandq_u32(a, b), vandq_u32(c, d));
+        case 7 :
+        case 8 : {
+            // as signed, true == -1, so sums are negated counts
+            int32x4_t ab = vaddq_s32(vreinterpretq_s32_u32(a), vreinterpretq_s32_u32(b));
+            int32x4_t cd = vaddq_s32(vreinterpretq_s32_u32(c), vreinterpretq_s32_u32(d));
+            return OP == 7 ? vcltq_s32(ab, cd) : vcgtq_s32(ab, cd);
+        }
+        default: return vdupq_n_u32(M_FALSE);
+    }
+}
+
+#endif
+
+// expand mask to 0.0f/1.0f
+inline void maskToFloat(const uint32_t *mask, float *out, unsigned n) {
+    unsigned i = 0;
+#ifdef LOGI_USE_NEON
+    const uint32x4_t one = vdupq_n_u32(F_ONE);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(out + i, vreinterpretq_f32_u32(vandq_u32(vld1q_u32(mask + i), one)));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = mask[i] ? 1.0f : 0.0f;
+    }
+}
+
+template<int OP>
+void pairKernel(const uint32_t *a, const uint32_t *b, uint32_t *res, unsigned n) {
+    unsigned i = 0;
+#ifdef LOGI_USE_NEON
+    for (; i + 4 <= n; i += 4) {
+        vst1q_u32(res + i, pairOp<OP>(vld1q_u32(a + i), vld1q_u32(b + i)));
+    }
+#endif
+    for (; i < n; i++) {
+        res[i] = pairOp<OP>(a[i], b[i]);
+    }
+}
+
+template<int OP>
+void allKernel(const uint32_t *a, const uint32_t *b, const uint32_t *c, const uint32_t *d,
+               uint32_t *res, unsigned n) {
+    unsigned i = 0;
+#ifdef LOGI_USE_NEON
+    for (; i + 4 <= n; i += 4) {
+        vst1q_u32(res + i, allOp<OP>(vld1q_u32(a + i), vld1q_u32(b + i), vld1q_u32(c + i), vld1q_u32(d + i)));
+    }
+#endif
+    for (; i < n; i++) {
+        res[i] = allOp<OP>(a[i], b[i], c[i], d[i]);
+    }
+}
+
+using PairKernel = void (*)(const uint32_t *, const uint32_t *, uint32_t *, unsigned);
+using AllKernel = void (*)(const uint32_t *, const uint32_t *, const uint32_t *, const uint32_t *,
+                           uint32_t *, unsigned);
+
+static const PairKernel pairKernels[] = {
+    pairKernel<0>, pairKernel<1>, pairKernel<2>, pairKernel<3>, pairKernel<4>,
+    pairKernel<5>, pairKernel<6>, pairKernel<7>, pairKernel<8>
+};
+
+static const AllKernel allKernels[] = {
+    allKernel<0>, allKernel<1>, allKernel<2>, allKernel<3>, allKernel<4>,
+    allKernel<5>, allKernel<6>, allKernel<7>, allKernel<8>
+};
+
+
+void PluginProcessor::gateMask(const float *in, unsigned n, float level, float hyst, bool inv,
+                               uint32_t *mask, bool &state) {
+    const uint32_t invMask = inv ? M_TRUE : M_FALSE;
+    if (hyst > 0.0f) {
+        // schmitt trigger, inherently serial
+        const float hi = level + hyst;
+        const float lo = level - hyst;
+        bool s = state;
+        for (unsigned i = 0; i < n; i++) {
+            s = s ? in[i] > lo : in[i] > hi;
+            mask[i] = (s ? M_TRUE : M_FALSE) ^ invMask;
+        }
+        state = s;
+        return;
+    }
+
+    unsigned i = 0;
+#ifdef LOGI_USE_NEON
+    const float32x4_t lvl = vdupq_n_f32(level);
+    const uint32x4_t vinv = vdupq_n_u32(invMask);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_u32(mask + i, veorq_u32(vcgtq_f32(vld1q_f32(in + i), lvl), vinv));
+    }
+#endif
+    for (; i < n; i++) {
+        mask[i] = (in[i] > level ? M_TRUE : M_FALSE) ^ invMask;
+    }
+    // keep schmitt state in step, so enabling hysteresis does not glitch
+    if (n > 0) state = in[n - 1] > level;
+}
+
+
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+    const float trigLevel = normValue(params_.triglevel);
+    const float hyst = normValue(params_.hysteresis);
     const unsigned sz = buffer.getNumSamples();
     const OperType op = OperType(normValue(params_.oper));
+
+    for (unsigned offset = 0; offset < sz; offset += MAX_CHUNK) {
+        processChunk(buffer, offset, std::min(MAX_CHUNK, sz - offset), op, trigLevel, hyst);
+    }
+}
+
+
+void PluginProcessor::processChunk(AudioSampleBuffer &buffer, unsigned offset, unsigned n,
+                                   OperType op, float trigLevel, float hyst) {
     const float def = defValue_[op];
+    const bool isCmp = op == OT_GT || op == OT_LT;
+    const PairKernel pairK = pairKernels[op];
+    const AllKernel allK = allKernels[op];
 
+    // note: outputs share channels with inputs (e.g. Out 1 == In B1),
+    // so each pair's inputs are fully read before its output is written
     for (unsigned i = 0; i < N_PAIRS; i++) {
         auto ain = i * 2, bin = ain + 1;
-        auto abuf = buffer.getReadPointer(ain);
-        auto bbuf = buffer.getReadPointer(bin);
         auto ainv = params_.gateparams_[ain]->inv.getValue() > 0.5f;
         auto binv = params_.gateparams_[bin]->inv.getValue() > 0.5f;
         unsigned gout = i + 1;
-        for (int smp = 0; smp < sz; smp++) {
-            bool res;
-            float af = inputEnabled[ain] ? abuf[smp] : def;
-            float bf = inputEnabled[bin] ? bbuf[smp] : def;
-            bool a = af > trigLevel;
-            bool b = bf > trigLevel;
-            if (ainv) {
-                a = !a;
-                af = af * -1.0f;
+
+        float af = inputEnabled[ain] ? buffer.getSample(ain, offset) : def;
+        float bf = inputEnabled[bin] ? buffer.getSample(bin, offset) : def;
+        if (ainv) af = af * -1.0f;
+        if (binv) bf = bf * -1.0f;
+
+        if (isCmp) {
+            // comparator, schmitt on the difference (a-b for GT, b-a for LT) around zero
+            float *d = cmpBuf_;
+            float sa = ainv ? -1.0f : 1.0f;
+            float sb = binv ? -1.0f : 1.0f;
+            if (op == OT_LT) {
+                sa = -sa;
+                sb = -sb;
             }
-            if (binv) {
-                b = !b;
-                bf = bf * -1.0f;
+            if (inputEnabled[ain]) {
+                FloatVectorOperations::copyWithMultiply(d, buffer.getReadPointer(ain, offset), sa, n);
+            } else {
+                FloatVectorOperations::fill(d, def * sa, n);
             }
-            switch (op) {
-                case OT_AND :
-                    res = a && b;
-                    break;
-                case OT_OR :
-                    res = a || b;
-                    break;
-                case OT_XOR:
-                    res = a != b;
-                    break;
-                case OT_NAND :
-                    res = !(a && b);
-                    break;
-                case OT_NOR :
-                    res = a == b;
-                    break;
-                case OT_NOT_A :
-                    res = !a;
-                    break;
-                case OT_NOT_B :
-                    res = !b;
-                    break;
-                case OT_GT :
-                    res = af > bf;
-                    break;
-                case OT_LT :
-                    res = af < bf;
-                    break;
-                default:
-                    break;
+            if (inputEnabled[bin]) {
+                FloatVectorOperations::addWithMultiply(d, buffer.getReadPointer(bin, offset), -sb, n);
+            } else {
+                FloatVectorOperations::add(d, -def * sb, n);
             }
-            buffer.setSample(gout, smp, res);
-            if (smp == 0) {
-                lastIn_[ain] = af;
-                lastIn_[bin] = bf;
-                lastOut_[gout] = res;
+            gateMask(d, n, 0.0f, hyst, false, outMask_[i], cmpState_[i]);
+        } else {
+            uint32_t *am = inMask_[ain];
+            uint32_t *bm = inMask_[bin];
+            if (inputEnabled[ain]) {
+                gateMask(buffer.getReadPointer(ain, offset), n, trigLevel, hyst, ainv, am, gateState_[ain]);
+            } else {
+                std::fill(am, am + n, ((def > trigLevel) != ainv) ? M_TRUE : M_FALSE);
             }
+            if (inputEnabled[bin]) {
+                gateMask(buffer.getReadPointer(bin, offset), n, trigLevel, hyst, binv, bm, gateState_[bin]);
+            } else {
+                std::fill(bm, bm + n, ((def > trigLevel) != binv) ? M_TRUE : M_FALSE);
+            }
+            pairK(am, bm, outMask_[i], n);
         }
-    } // pair
-    // build up the main output by combining the pairs
 
+        maskToFloat(outMask_[i], buffer.getWritePointer(gout, offset), n);
+        if (offset == 0) {
+            lastIn_[ain] = af;
+            lastIn_[bin] = bf;
+            lastOut_[gout] = outMask_[i][0] != M_FALSE;
+        }
+    } // pair
 
-    auto buf1 = buffer.getReadPointer(O_OUT_1);
-    auto buf2 = buffer.getReadPointer(O_OUT_2);
-    auto buf3 = buffer.getReadPointer(O_OUT_3);
-    auto buf4 = buffer.getReadPointer(O_OUT_4);
-    for (int smp = 0; smp < sz; smp++) {
-        bool res;
-        bool a = buf1[smp] > trigLevel;
-        bool b = buf2[smp] > trigLevel;
-        bool c = buf3[smp] > trigLevel;
-        bool d = buf4[smp] > trigLevel;
-        switch (op) {
-            case OT_AND :
-                res = a && b && c && d;
-                break;
-            case OT_OR :
-                res = a || b || c || d;
-                break;
-            case OT_XOR:
-                res = (a != b) != (c != d);
-                break;
-            case OT_NAND :
-                res = !(a && b && c && d);
-                break;
-            case OT_NOR :
-                res = (a == b) == (c == d);
-                break;
-            case OT_NOT_A :
-            case OT_NOT_B :
-                res = a && b && c && d;
-                break;
-            case OT_GT:
-                res = (a + b) > (c + d);
-                break;
-            case OT_LT:
-                res = (a + b) < (c + d);
-                break;
-            default:
-                break;
+    // build up the main output by combining the pairs
+    // the pair outputs (0.0f/1.0f) are compared against trig level
+    if (trigLevel < 0.0f || trigLevel >= 1.0f) {
+        const uint32_t v = trigLevel < 0.0f ? M_TRUE : M_FALSE;
+        for (unsigned i = 0; i < N_PAIRS; i++) {
+            std::fill(outMask_[i], outMask_[i] + n, v);
         }
-        buffer.setSample(O_OUT_ALL, smp, res);
-        if (smp == 0) lastOut_[O_OUT_ALL] = res;
     }
+
+    uint32_t *res = inMask_[0]; // inputs are consumed, reuse as scratch
+    allK(outMask_[0], outMask_[1], outMask_[2], outMask_[3], res, n);
+    maskToFloat(res, buffer.getWritePointer(O_OUT_ALL, offset), n);
+    if (offset == 0) lastOut_[O_OUT_ALL] = res[0] != M_FALSE;
 }
 
 void PluginProcessor::getValues(float *inputs, bool *outputs) {
@@ -14,6 +14,7 @@ constexpr const char *separator{":"};
 
 PARAMETER_ID (oper)
 PARAMETER_ID (triglevel)
+PARAMETER_ID (hysteresis)
 
 PARAMETER_ID (gates)
 PARAMETER_ID (inv)
@@ -29,7 +30,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -48,6 +49,7 @@ public:
 
         Parameter &oper;
         Parameter &triglevel;
+        Parameter &hysteresis;
         std::vector<std::unique_ptr<GateParam>> gateparams_;
     } params_;
 
@@ -82,6 +84,8 @@ public:
         O_OUT_4,
         O_MAX
     };
+
+    static constexpr unsigned N_PAIRS = I_MAX / 2;
 protected:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
@@ -106,6 +110,27 @@ private:
     inline float normValue(RangedAudioParameter &p) {
         return p.convertFrom0to1(p.getValue());
     }
+
+    // gates are processed as masks (0 / 0xFFFFFFFF per sample) in chunks of MAX_CHUNK
+    static constexpr unsigned MAX_CHUNK = 128;
+
+    void processChunk(AudioSampleBuffer &buffer, unsigned offset, unsigned n,
+                      OperType op, float trigLevel, float hyst);
+
+    void gateMask(const float *in, unsigned n, float level, float hyst, bool inv, uint32_t *mask, bool &state);
+
+    alignas(16) uint32_t inMask_[I_MAX][MAX_CHUNK];
+    alignas(16) uint32_t outMask_[N_PAIRS][MAX_CHUNK];
+    alignas(16) float cmpBuf_[MAX_CHUNK];
+
+    // schmitt trigger state, per input, and per pair for comparators
+    bool gateState_[I_MAX] = {
+        false, false, false, false,
+        false, false, false, false
+    };
+    bool cmpState_[N_PAIRS] = {
+        false, false, false, false
+    };
     float  defValue_[OT_MAX] = { 1.0f , 0.0f , 0.0f, 0.0f, 0.0f, 0.0f, 0.0f ,0.0f, 0.0f };
 
     static const String getInputBusName(int channelIndex);
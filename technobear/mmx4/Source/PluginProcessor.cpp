@@ -149,7 +149,7 @@ void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     workBuf_.setSize(1, samplesPerBlock);
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned n = buffer.getNumSamples();
 
     for (unsigned i = 0; i < MAX_SIG_OUT * 2; i++) {
@@ -98,7 +98,7 @@ void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     lastBuffer_.setSize(1, samplesPerBlock);
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned n = buffer.getNumSamples();
     unsigned n2 = n / 2;
     float cvInS = buffer.getSample(I_IN_SEL, 0);
@@ -34,7 +34,7 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
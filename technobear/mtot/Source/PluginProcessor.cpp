@@ -108,7 +108,14 @@ int PluginProcessor::getCCNum(int idx) {
 }
 
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
+    BaseProcessor::prepareToPlay(sampleRate, samplesPerBlock);
+    // worst case, a message per input (cc, pitchbend, note) on every sample
+    midiOut_.ensureSize(size_t(samplesPerBlock) * I_MAX * MIDI_EVENT_BYTES);
+}
+
+
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     if (midiOutDevice_ == nullptr || !(midiOutDevice_->isBackgroundThreadRunning())) {
         return;
     }
@@ -117,7 +124,8 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
 
     static constexpr unsigned max_cc = I_CV_H - I_CV_A;
 
-    MidiBuffer midimsgs;
+    auto &midimsgs = midiOut_;
+    midimsgs.clear();
 
     for (int smp = 0; smp < sz; smp++) {
         for (int i = 0; i < max_cc; i++) {
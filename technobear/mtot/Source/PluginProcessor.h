@@ -33,7 +33,8 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -101,6 +102,11 @@ private:
     int lastMidi_[I_MAX];
     int pitchbend_=8192;
 
+    // messages for a block, sized in prepareToPlay, so adding events does not allocate
+    // upper bound, bytes per (3 byte) event, plus its position and size
+    static constexpr size_t MIDI_EVENT_BYTES = 16;
+    MidiBuffer midiOut_;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };
 
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "ssp/Float4.h"
+
+#include <cmath>
+#include <cstring>
+
+// wavetables shared by all instances, built on first use
+// sine, and band limited (mip mapped per octave) triangle, saw and square
+class OscTables {
+public:
+    static constexpr unsigned SIZE = 2048;
+    static_assert((SIZE & (SIZE - 1)) == 0, "table index is masked");
+    static constexpr unsigned LEVELS = 11; // level L has (SIZE / 2) >> L harmonics
+
+    enum BandLimited {
+        BL_TRI,
+        BL_SAW,
+        BL_SQR,
+        BL_MAX
+    };
+
+    static const OscTables &get() {
+        static OscTables tables;
+        return tables;
+    }
+
+    // wrap phase (table position) into 0..1 (exclusive), p - floorf(p) gives 1.0f for tiny negative p
+    static float wrap(float p) {
+        p -= floorf(p);
+        return p < 1.0f ? p : 0.0f;
+    }
+
+    // tables have a guard point, so SIZE + 1 entries
+    const float *sine() const { return sine_; }
+
+    const float *bandLimited(BandLimited w, unsigned level) const { return bl_[w][level]; }
+
+    // level for a phase increment (cycles per sample), so no harmonic is above nyquist
+    static unsigned level(float inc) {
+        float h = inc * float(SIZE);
+        unsigned l = 0;
+        while (h > 1.0f && l < LEVELS - 1) {
+            h *= 0.5f;
+            l++;
+        }
+        return l;
+    }
+
+private:
+    OscTables() {
+        for (unsigned i = 0; i <= SIZE; i++) {
+            sine_[i] = sinf(2.0f * float(M_PI) * float(i % SIZE) / float(SIZE));
+        }
+
+        for (unsigned l = 0; l < LEVELS; l++) {
+            unsigned maxH = (SIZE / 2) >> l;
+            float *tri = bl_[BL_TRI][l];
+            float *saw = bl_[BL_SAW][l];
+            float *sqr = bl_[BL_SQR][l];
+            for (unsigned i = 0; i < SIZE; i++) {
+                double t = 0.0, sw = 0.0, sq = 0.0;
+                for (unsigned h = 1; h <= maxH; h++) {
+                    unsigned si = (h * i) % SIZE;
+                    unsigned ci = (si + (SIZE / 4)) % SIZE;
+                    sw += sine_[si] / double(h);
+                    if (h & 1) {
+                        sq += sine_[si] / double(h);
+                        t += sine_[ci] / double(h * h);
+                    }
+                }
+                // match the naive shapes : tri starts at 1, saw falls 1 to -1, square at 0.707 (as daisysp blep)
+                tri[i] = float(t * 8.0 / (M_PI * M_PI));
+                saw[i] = float(sw * 2.0 / M_PI);
+                sqr[i] = float(sq * 4.0 / M_PI) * 0.707f;
+            }
+            tri[SIZE] = tri[0];
+            saw[SIZE] = saw[0];
+            sqr[SIZE] = sqr[0];
+        }
+    }
+
+    float sine_[SIZE + 1];
+    float bl_[BL_MAX][LEVELS][SIZE + 1];
+};
+
+
+// bank of oscillators, structure of arrays, processed in float4 lanes
+// phase is normalised (0-1), waveforms follow daisysp::Oscillator
+template<unsigned N_GROUPS>
+class OscBank {
+public:
+    static constexpr unsigned N_LANES = ssp::float4::N;
+    static constexpr unsigned N_OSC = N_GROUPS * N_LANES;
+
+    enum Waveform {
+        W_SIN,
+        W_TRI,
+        W_SAW,
+        W_RAMP,
+        W_SQUARE,
+        W_BL_TRI,
+        W_BL_SAW,
+        W_BL_SQUARE,
+        W_MAX
+    };
+
+    OscBank() : tables_(OscTables::get()) {
+        for (unsigned o = 0; o < N_OSC; o++) {
+            phase_[o] = 0.0f;
+            amp_[o] = 1.0f;
+            ratio_[o] = 1.0f;
+            wave_[o] = W_SIN;
+            table_[o] = tables_.sine();
+        }
+        updateMasks();
+    }
+
+    void setWaveform(unsigned o, Waveform w) {
+        if (wave_[o] != w) {
+            wave_[o] = w;
+            updateMasks();
+        }
+    }
+
+    void setAmp(unsigned o, float a) { amp_[o] = a; }
+
+    // frequency relative to the bank frequency
+    void setRatio(unsigned o, float r) { ratio_[o] = r; }
+
+    float ratio(unsigned o) const { return ratio_[o]; }
+
+    float phase(unsigned o) const { return phase_[o]; }
+
+    void phase(unsigned o, float p) { phase_[o] = OscTables::wrap(p); }
+
+    // add (normalised) phase offset
+    void phaseAdd(unsigned o, float p) { phase(o, phase_[o] + p); }
+
+    // select mip level for band limited tables, call at control rate with highest inc expected
+    void updateTables(float inc) {
+        for (unsigned o = 0; o < N_OSC; o++) {
+            unsigned l = OscTables::level(inc * ratio_[o]);
+            switch (wave_[o]) {
+                case W_BL_TRI :
+                    table_[o] = tables_.bandLimited(OscTables::BL_TRI, l);
+                    break;
+                case W_BL_SAW :
+                    table_[o] = tables_.bandLimited(OscTables::BL_SAW, l);
+                    break;
+                case W_BL_SQUARE :
+                    table_[o] = tables_.bandLimited(OscTables::BL_SQR, l);
+                    break;
+                default:
+                    table_[o] = tables_.sine();
+                    break;
+            }
+        }
+    }
+
+    // advance all oscillators one sample at bank phase increment (cycles per sample)
+    // out and eoc receive N_OSC values, eoc is 1.0f on the sample a cycle ends
+    inline void process(float inc, float *out, float *eoc, bool *groupActive) {
+        const ssp::float4 vinc = ssp::float4::dup(inc);
+        const ssp::float4 one = ssp::float4::dup(1.0f);
+        const ssp::float4 two = ssp::float4::dup(2.0f);
+        const ssp::float4 half = ssp::float4::dup(0.5f);
+
+        for (unsigned g = 0; g < N_GROUPS; g++) {
+            if (!groupActive[g]) continue;
+
+            const unsigned o = g * N_LANES;
+            ssp::float4 p = ssp::float4::load(phase_ + o);
+
+            // naive shapes
+            ssp::float4 ramp = (p * two) - one;
+            ssp::float4 saw = one - (p * two);
+            ssp::float4 tri = (ssp::float4::abs(ramp) * two) - one;
+            alignas(16) uint32_t firstHalf[N_LANES];
+            ssp::float4::lt(p, half, firstHalf);
+            ssp::float4 sqr = ssp::float4::select(firstHalf, one, ssp::float4::dup(-1.0f));
+
+            ssp::float4 v = ssp::float4::select(mTri_[g], tri,
+                                                ssp::float4::select(mSaw_[g], saw,
+                                                                    ssp::float4::select(mRamp_[g], ramp, sqr)));
+
+            if (anyTable_[g]) {
+                // sine and band limited, table lookup with linear interpolation
+                ssp::float4 pos = p * ssp::float4::dup(float(OscTables::SIZE));
+                alignas(16) int32_t idx[N_LANES];
+                pos.toInt(idx);
+                ssp::float4 frac = pos - ssp::float4::fromInt(idx);
+                alignas(16) float t0[N_LANES], t1[N_LANES];
+                for (unsigned l = 0; l < N_LANES; l++) {
+                    const float *t = table_[o + l];
+                    // mask, so rounding at the end of the cycle cannot read past the guard point
+                    unsigned i = unsigned(idx[l]) & (OscTables::SIZE - 1);
+                    t0[l] = t[i];
+                    t1[l] = t[i + 1];
+                }
+                ssp::float4 a = ssp::float4::load(t0);
+                ssp::float4 tv = ssp::float4::madd(a, ssp::float4::load(t1) - a, frac);
+                v = ssp::float4::select(mTable_[g], tv, v);
+            }
+
+            (v * ssp::float4::load(amp_ + o)).store(out + o);
+
+            // advance, wrap and flag end of cycle
+            p = ssp::float4::madd(p, ssp::float4::load(ratio_ + o), vinc);
+            alignas(16) int32_t wraps[N_LANES];
+            p.toInt(wraps);
+            p = p - ssp::float4::fromInt(wraps);
+            p.store(phase_ + o);
+            for (unsigned l = 0; l < N_LANES; l++) {
+                eoc[o + l] = wraps[l] != 0 ? 1.0f : 0.0f;
+            }
+        }
+    }
+
+private:
+    void updateMasks() {
+        for (unsigned g = 0; g < N_GROUPS; g++) {
+            anyTable_[g] = false;
+            for (unsigned l = 0; l < N_LANES; l++) {
+                unsigned o = g * N_LANES + l;
+                Waveform w = wave_[o];
+                bool table = w == W_SIN || w >= W_BL_TRI;
+                mTable_[g][l] = table ? 0xFFFFFFFF : 0;
+                mTri_[g][l] = w == W_TRI ? 0xFFFFFFFF : 0;
+                mSaw_[g][l] = w == W_SAW ? 0xFFFFFFFF : 0;
+                mRamp_[g][l] = w == W_RAMP ? 0xFFFFFFFF : 0;
+                anyTable_[g] |= table;
+            }
+        }
+    }
+
+    const OscTables &tables_;
+
+    alignas(16) float phase_[N_OSC];
+    alignas(16) float amp_[N_OSC];
+    alignas(16) float ratio_[N_OSC];
+    Waveform wave_[N_OSC];
+    const float *table_[N_OSC];
+
+    // per lane waveform selection, square when none set
+    alignas(16) uint32_t mTable_[N_GROUPS][N_LANES];
+    alignas(16) uint32_t mTri_[N_GROUPS][N_LANES];
+    alignas(16) uint32_t mSaw_[N_GROUPS][N_LANES];
+    alignas(16) uint32_t mRamp_[N_GROUPS][N_LANES];
+    bool anyTable_[N_GROUPS];
+};
@@ -32,7 +32,7 @@ PluginEditor::PluginEditor(PluginProcessor &p)
     addButtonPage(
         nullptr,
         std::make_shared<bcontrol_type>(processor_.params_.lfo, 32, Colours::lightskyblue),
-        nullptr,
+        std::make_shared<bcontrol_type>(processor_.params_.clksync, 32, Colours::lightskyblue),
         nullptr,
         nullptr,
         nullptr,
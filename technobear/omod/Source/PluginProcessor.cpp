@@ -2,10 +2,6 @@
 #include "PluginEditor.h"
 #include "ssp/EditorHost.h"
 
-inline float constrain(float v, float vMin, float vMax) {
-    return std::max<float>(vMin, std::min<float>(vMax, v));
-}
-
 #define MAX_FREQ 24000.0f
 #define MIN_FREQ (1.0f / 600.0f)
 // min freq only used for cv freq
@@ -45,7 +41,8 @@ PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt)
     freq(*apvt.getParameter(ID::freq)),
     amp(*apvt.getParameter(ID::amp)),
     phase(*apvt.getParameter(ID::phase)),
-    lfo(*apvt.getParameter(ID::lfo)) {
+    lfo(*apvt.getParameter(ID::lfo)),
+    clksync(*apvt.getParameter(ID::clksync)) {
     for (unsigned oid = 0; oid < MAX_S_OSC; oid++) {
         auto sosc = std::make_unique<SlaveOscParams>(apvt, oid);
         slaveOscsParams_.push_back(std::move(sosc));
@@ -86,6 +83,8 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     }
     params.add(std::move(taps));
 
+    // added after slave oscs, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseBoolParameter>(ID::clksync, "Clk Sync", false));
 
     return params;
 }
@@ -129,134 +128,178 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 
 void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPerBlock) {
     BaseProcessor::prepareToPlay(newSampleRate, estimatedSamplesPerBlock);
-    mainOsc_.Init(newSampleRate);
-    for (int oid = 0; oid < MAX_S_OSC; oid++) {
-        slaveOscs_[oid].osc_.Init(newSampleRate);
+    workBuf_.setSize(W_MAX, estimatedSamplesPerBlock);
+    for (unsigned o = 0; o < N_OSC; o++) {
+        oscs_.phase(o, oscPhase_[o]);
     }
 }
 
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::syncToClock(float elapsed, float inc, float *eoc) {
+    // ratio locked, each osc is placed where it would be after clockCount_ clocks (since reset)
+    // plus the time elapsed since the (sub sample) clock edge
+    for (unsigned o = 0; o < N_OSC; o++) {
+        double ratio = oscs_.ratio(o);
+        double cycles = ratio * clockCount_;
+        float target = oscPhase_[o] + float(cycles - std::floor(cycles)) + (float(ratio) * inc * elapsed);
+        target = OscTables::wrap(target);
+        float cur = oscs_.phase(o);
+        // jumped forward over the end of cycle
+        if (cur - target > 0.5f) eoc[o] = 1.0f;
+        oscs_.phase(o, target);
+    }
+}
+
 
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+    static constexpr float trigLevel = 0.5f;
     unsigned sz = buffer.getNumSamples();
-    float freqmult = (params_.lfo.getValue() > 0.5f) ? 0.01f : 1.0f;
+    if (workBuf_.getNumSamples() < sz) workBuf_.setSize(W_MAX, sz, false, false, true);
 
+    float freqmult = (params_.lfo.getValue() > 0.5f) ? 0.01f : 1.0f;
     float mainfreq = normValue(params_.freq) * freqmult;
     float freqRange = mainfreq;
-    float mainwave = normValue(params_.wave);
-    float mainamp = normValue(params_.amp);
-    float mainphase = params_.phase.getValue();
     bool usingClock = isInputEnabled(I_CLOCK);
-
-    mainOsc_.SetWaveform(mainwave);
-    mainOsc_.SetAmp(mainamp);
-
-    if (mainphase != mainPhase_) {
-        float phaseAdd = mainphase - mainPhase_;
-        if (phaseAdd < 0.0f) phaseAdd += 1.0f;
-        mainPhase_ = mainphase;
-        mainOsc_.PhaseAdd(phaseAdd);
-    }
-
-    struct {
-        float ratio_ = 0.0f;
-    } slavevalues[MAX_S_OSC];
+    bool clockSync = usingClock && params_.clksync.getValue() > 0.5f;
+    float invSampleRate = 1.0f / float(getSampleRate());
 
     // control rate handling
-    for (int oid = 0; oid < MAX_S_OSC; oid++) {
-        if (!isOutputEnabled(O_OUT_A + oid)) continue;
-
-        auto &soscparams = params_.slaveOscsParams_[oid];
-        auto &sosc = slaveOscs_[oid];
-        float ratio = normValue(soscparams->ratio);
-        float wave = normValue(soscparams->wave);
-        float amp = normValue(soscparams->amp);
-        float phase = soscparams->phase.getValue();
-
+    for (unsigned o = 0; o < N_OSC; o++) {
+        float ratio = 1.0f;
+        float wave, amp, phase;
+        if (o == 0) {
+            wave = normValue(params_.wave);
+            amp = normValue(params_.amp);
+            phase = params_.phase.getValue();
+        } else {
+            auto &soscparams = params_.slaveOscsParams_[o - 1];
+            ratio = normValue(soscparams->ratio);
+            wave = normValue(soscparams->wave);
+            amp = normValue(soscparams->amp);
+            phase = soscparams->phase.getValue();
+        }
 
-        slavevalues[oid].ratio_ = ratio;
-        sosc.osc_.SetWaveform(wave);
-        sosc.osc_.SetAmp(amp);
+        oscs_.setWaveform(o, OscBank<N_OSC_GROUPS>::Waveform(int(wave)));
+        oscs_.setAmp(o, amp);
+        oscs_.setRatio(o, ratio);
+        if (oscPhase_[o] != phase) {
+            oscs_.phaseAdd(o, phase - oscPhase_[o]);
+            oscPhase_[o] = phase;
+        }
+    }
 
-        if (sosc.phase_ != phase) {
-            float phaseAdd = phase - sosc.phase_;
-            if (phaseAdd < 0.0f) phaseAdd += 1.0f;
-            sosc.phase_ = phase;
-            sosc.osc_.PhaseAdd(phaseAdd);
+    bool outEnabled[N_OSC];
+    bool groupActive[N_OSC_GROUPS];
+    for (unsigned o = 0; o < N_OSC; o++) {
+        outEnabled[o] = o == 0 || isOutputEnabled(O_OUT_A + o - 1) || isOutputEnabled(O_EOC_A + o - 1);
+    }
+    for (unsigned g = 0; g < N_OSC_GROUPS; g++) {
+        groupActive[g] = false;
+        for (unsigned l = 0; l < ssp::float4::N; l++) {
+            groupActive[g] |= outEnabled[g * ssp::float4::N + l];
         }
     }
 
     if (!usingClock) {
         lastClock_ = 0.0f;
         clockSampleCnt_ = 0;
-        clockFreq_ = 0.0f;
+        clockValid_ = false;
+        clockInc_ = 0.0f;
+    }
+
+    // block rate handling, inputs share channels with outputs, so take what we need first
+    float *inc = workBuf_.getWritePointer(W_INC);
+    float *reset = workBuf_.getWritePointer(W_RESET);
+    float *clock = workBuf_.getWritePointer(W_CLOCK);
+    FloatVectorOperations::copy(reset, buffer.getReadPointer(I_RESET), sz);
+    FloatVectorOperations::copy(clock, buffer.getReadPointer(I_CLOCK), sz);
+
+    FloatVectorOperations::fill(inc, mainfreq, sz);
+    if (isInputEnabled(I_VOCT)) {
+        // mtof(cv2Pitch(voct) + 60) = 440 * 2^(5 * voct - 0.75)
+        const float *voct = buffer.getReadPointer(I_VOCT);
+        unsigned s = 0;
+        const ssp::float4 five = ssp::float4::dup(5.0f);
+        const ssp::float4 offset = ssp::float4::dup(-0.75f);
+        const ssp::float4 a4 = ssp::float4::dup(440.0f);
+        for (; s + ssp::float4::N <= sz; s += ssp::float4::N) {
+            ssp::float4 f = ssp::float4::load(inc + s);
+            f = ssp::float4::madd(f, ssp::float4::pow2(ssp::float4::madd(offset, ssp::float4::load(voct + s), five)), a4);
+            f.store(inc + s);
+        }
+        for (; s < sz; s++) {
+            inc[s] += std::exp2(5.0f * voct[s] - 0.75f) * 440.0f;
+        }
+        FloatVectorOperations::clip(inc, inc, 0.0f, MAX_FREQ, sz);
+    }
+    if (isInputEnabled(I_FREQ)) {
+        FloatVectorOperations::addWithMultiply(inc, buffer.getReadPointer(I_FREQ), freqRange, sz);
+        FloatVectorOperations::clip(inc, inc, MIN_FREQ, MAX_FREQ, sz);
+    }
+    FloatVectorOperations::multiply(inc, invSampleRate, sz);
+
+    // pick band limited tables for the fastest rate expected in this block
+    float maxInc = usingClock ? clockInc_ : FloatVectorOperations::findMaximum(inc, sz);
+    oscs_.updateTables(maxInc);
+
+    float *outs[N_OSC];
+    float *eocs[N_OSC];
+    for (unsigned o = 0; o < N_OSC; o++) {
+        outs[o] = buffer.getWritePointer(O_OUT_MAIN + o);
+        eocs[o] = buffer.getWritePointer(O_EOC_MAIN + o);
     }
 
-    static constexpr float trigLevel = 0.5f;
     // sample rate processing
-    for (int s = 0; s < sz; s++) {
+    for (unsigned s = 0; s < sz; s++) {
+        alignas(16) float out[N_OSC];
+        alignas(16) float eoc[N_OSC];
+        float syncEoc[N_OSC] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
 
-        float fin = buffer.getSample(I_FREQ, s);
-        float clockSmp = buffer.getSample(I_CLOCK, s);
-        float resetSmp = buffer.getSample(I_RESET, s);
         bool resetTrig = requestReset_;
-
         requestReset_ = false;
-
-        if (resetSmp > trigLevel && lastReset_ <= trigLevel) {
+        if (reset[s] > trigLevel && lastReset_ <= trigLevel) {
             resetTrig = true;
         }
-        lastReset_ = resetSmp;
-
-        float mainoscfreq = mainfreq;
+        lastReset_ = reset[s];
 
-        if (isInputEnabled(I_VOCT)) {
-            float voct = buffer.getSample(I_VOCT, s);
-            float pitch = cv2Pitch(voct);
-            mainoscfreq += daisysp::mtof(pitch + 60.0f);
-            mainoscfreq = constrain(mainoscfreq, 0.0f, MAX_FREQ);
-        }
-
-        if (isInputEnabled(I_FREQ)) {
-            mainoscfreq += (fin * freqRange);
-            mainoscfreq = constrain(mainoscfreq, MIN_FREQ, MAX_FREQ);
+        if (resetTrig) {
+            for (unsigned o = 0; o < N_OSC; o++) {
+                oscs_.phase(o, oscPhase_[o]);
+            }
+            clockCount_ = 0;
         }
 
+        float oscinc = inc[s];
         if (usingClock) {
+            float clockSmp = clock[s];
             if (clockSmp > trigLevel && lastClock_ <= trigLevel) {
-                clockFreq_ = getSampleRate() / clockSampleCnt_;
+                // sub sample position of the edge, between last sample and this one
+                float frac = (trigLevel - lastClock_) / (clockSmp - lastClock_);
+                float period = float(clockSampleCnt_) + frac - lastClockFrac_;
+                if (clockValid_ && period > 0.0f) {
+                    clockInc_ = 1.0f / period;
+                }
+                clockValid_ = true;
                 clockSampleCnt_ = 0;
+                lastClockFrac_ = frac;
+                clockCount_ += 1;
+
+                if (clockSync && clockInc_ > 0.0f && !resetTrig) {
+                    syncToClock(1.0f - frac, clockInc_, syncEoc);
+                }
             }
             lastClock_ = clockSmp;
             clockSampleCnt_++;
 
-            mainoscfreq = clockFreq_;
-        }
-
-        if (mainoscfreq != mainFreq_) {
-            mainFreq_ = mainoscfreq;
-            mainOsc_.SetFreq(mainFreq_);
+            oscinc = clockInc_;
         }
 
-        if (resetTrig) mainOsc_.Reset(mainPhase_ * TWOPI_F);
-        buffer.setSample(O_OUT_MAIN, s, mainOsc_.Process());
-        buffer.setSample(O_EOC_MAIN, s, mainOsc_.IsEOC());
-        for (int oid = 0; oid < MAX_S_OSC; oid++) {
-            if (!(isOutputEnabled(O_OUT_A + oid) || (isOutputEnabled(O_EOC_A + oid)))) { continue; };
-
-            auto &sosc = slaveOscs_[oid];
-            auto &soscparam = slavevalues[oid];
-
-            float freq = mainoscfreq * soscparam.ratio_;
-            if (freq != sosc.freq_) {
-                sosc.freq_ = freq;
-                sosc.osc_.SetFreq(sosc.freq_);
-            }
-
-            if (resetTrig) sosc.osc_.Reset(sosc.phase_ * TWOPI_F);
+        oscs_.process(oscinc, out, eoc, groupActive);
 
-            buffer.setSample(O_OUT_A + oid, s, sosc.osc_.Process());
-            buffer.setSample(O_EOC_A + oid, s, sosc.osc_.IsEOC());
+        for (unsigned o = 0; o < N_OSC; o++) {
+            if (!outEnabled[o]) continue;
+            outs[o][s] = out[o];
+            eocs[o][s] = std::max(eoc[o], syncEoc[o]);
         }
     }
 
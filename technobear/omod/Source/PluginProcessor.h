@@ -9,6 +9,8 @@
 #include <atomic>
 #include <algorithm>
 
+#include "OscBank.h"
+
 namespace ID {
 #define PARAMETER_ID(str) constexpr const char* str { #str };
 constexpr const char *separator{":"};
@@ -19,6 +21,7 @@ PARAMETER_ID (freq)
 PARAMETER_ID (amp)
 PARAMETER_ID (phase)
 PARAMETER_ID (lfo)
+PARAMETER_ID (clksync)
 
 
 // slaveosc : 1-7
@@ -41,7 +44,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -101,6 +104,7 @@ public:
         Parameter &amp;
         Parameter &phase;
         Parameter &lfo;
+        Parameter &clksync;
 
         std::vector<std::unique_ptr<SlaveOscParams>> slaveOscsParams_;
     } params_;
@@ -135,20 +139,30 @@ private:
 
     inline float normValue(RangedAudioParameter &p) { return p.convertFrom0to1(p.getValue()); }
 
-    daisysp::Oscillator mainOsc_;
-    float mainPhase_=0.0f;
-    float mainFreq_=0.0f;
+    // main oscillator is osc 0, slaves are 1-7
+    static constexpr unsigned N_OSC = MAX_S_OSC + 1;
+    static constexpr unsigned N_OSC_GROUPS = N_OSC / ssp::float4::N;
+    static_assert(N_OSC % ssp::float4::N == 0, "oscillators are processed as float4 lanes");
+    OscBank<N_OSC_GROUPS> oscs_;
+    float oscPhase_[N_OSC] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
 
-    struct {
-        daisysp::Oscillator osc_;
-        float phase_=0.0f;
-        float freq_=0.0f;
+    void syncToClock(float elapsed, float inc, float *eoc);
 
-    } slaveOscs_[MAX_S_OSC];
+    // freq (as phase inc), reset and clock, read before outputs are written
+    AudioSampleBuffer workBuf_;
+    enum {
+        W_INC,
+        W_RESET,
+        W_CLOCK,
+        W_MAX
+    };
 
-    int clockSampleCnt_=0;
+    unsigned clockSampleCnt_ = 0;
     float lastClock_ = 0.0f;
-    float clockFreq_ = 0.0f;
+    float lastClockFrac_ = 0.0f;
+    bool clockValid_ = false;
+    float clockInc_ = 0.0f;
+    double clockCount_ = 0; // clocks since reset
 
     float lastReset_ = 0.0f;
     bool requestReset_ = false;
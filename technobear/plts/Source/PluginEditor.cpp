@@ -28,7 +28,7 @@ PluginEditor::PluginEditor(PluginProcessor &p)
     addParamPage(
         std::make_shared<pcontrol_type>(processor_.params_.lpg),
         std::make_shared<pcontrol_type>(processor_.params_.vca),
-        nullptr,
+        std::make_shared<pcontrol_type>(processor_.params_.voices, 1.0f, 1.0f),
         nullptr);
 
 
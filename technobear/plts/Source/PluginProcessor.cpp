@@ -14,6 +14,8 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
     init();
+    fadeOnStateLoad(O_OUT);
+    fadeOnStateLoad(O_AUX);
 
     memset(shared_buffer_, 0, sizeof(shared_buffer_));
 #if __APPLE__
@@ -34,7 +36,8 @@ PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt)
     timbre_mod(*apvt.getParameter(ID::timbre_mod)),
     morph_mod(*apvt.getParameter(ID::morph_mod)),
     lpg(*apvt.getParameter(ID::lpg)),
-    vca(*apvt.getParameter(ID::vca)) {
+    vca(*apvt.getParameter(ID::vca)),
+    voices(*apvt.getParameter(ID::voices)) {
 }
 
 
@@ -75,6 +78,8 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
 
     params.add(std::make_unique<ssp::BaseFloatParameter>(ID::lpg, "LPG", 0.0f, 100.0f, 50.0f));
     params.add(std::make_unique<ssp::BaseFloatParameter>(ID::vca, "VCA", 0.0f, 100.0f, 50.0f));
+    // added after vca, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::voices, "Voices", StringArray{"1", "2", "4"}, 0));
     return params;
 }
 
@@ -88,7 +93,13 @@ const String PluginProcessor::getInputBusName(int channelIndex) {
         "Timbre",
         "Morph",
         "FM",
-        "Model"
+        "Model",
+        "VOct 2",
+        "Trig 2",
+        "VOct 3",
+        "Trig 3",
+        "VOct 4",
+        "Trig 4"
     };
     if (channelIndex < I_MAX) { return inBusName[channelIndex]; }
     return "ZZIn-" + String(channelIndex);
@@ -106,11 +117,51 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     BaseProcessor::prepareToPlay(sampleRate, samplesPerBlock);
-    stmlib::BufferAllocator allocator(shared_buffer_, sizeof(shared_buffer_));
-    voice_.Init(&allocator);
+    for (unsigned v = 0; v < MAX_VOICES; v++) {
+        stmlib::BufferAllocator allocator(shared_buffer_ + (v * VOICE_ARENA), VOICE_ARENA);
+        voices_[v].Init(&allocator);
+        voiceState_[v] = VoiceState();
+    }
+}
+
+void PluginProcessor::midiNoteInput(unsigned note, unsigned velocity) {
+    if (velocity > 0) noteInputTranspose_ = float(note) - 60.f;
+
+    // midi thread, drop if audio thread has fallen behind
+    unsigned wr = noteWr_.load(std::memory_order_relaxed);
+    if (wr - noteRd_.load(std::memory_order_acquire) >= MAX_NOTE_EVENTS) return;
+    noteQueue_[wr % MAX_NOTE_EVENTS] = {uint8(note), uint8(velocity)};
+    noteWr_.store(wr + 1, std::memory_order_release);
+}
+
+void PluginProcessor::noteEvent(unsigned note, unsigned velocity, unsigned nVoices) {
+    float transpose = float(note) - 60.f;
+    if (velocity == 0) {
+        for (unsigned v = 0; v < nVoices; v++) {
+            auto &vs = voiceState_[v];
+            if (vs.held && vs.noteTranspose == transpose) vs.held = false;
+        }
+        return;
+    }
+
+    // released voice used longest ago, otherwise steal the oldest
+    int voice = -1;
+    for (unsigned pass = 0; pass < 2 && voice < 0; pass++) {
+        for (unsigned v = 0; v < nVoices; v++) {
+            auto &vs = voiceState_[v];
+            if (pass == 0 && vs.held) continue;
+            if (voice < 0 || vs.age < voiceState_[voice].age) voice = v;
+        }
+    }
+
+    auto &vs = voiceState_[voice];
+    vs.noteTranspose = transpose;
+    vs.held = true;
+    vs.age = ++allocCount_;
+    vs.trigPending = true;
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     auto n = PltsBlock;
 
     bool auxOut = outputEnabled[O_AUX];
@@ -119,24 +170,44 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
     bool fmEn = inputEnabled[I_FM];
     bool timbreEn = inputEnabled[I_TIMBRE];
     bool morphEn = inputEnabled[I_MORPH];
-    bool trigEn = inputEnabled[I_TRIG];
     bool levelEn = inputEnabled[I_LEVEL];
 
+    static constexpr unsigned voctIn[MAX_VOICES] = {I_VOCT, I_VOCT_2, I_VOCT_3, I_VOCT_4};
+    static constexpr unsigned trigIn[MAX_VOICES] = {I_TRIG, I_TRIG_2, I_TRIG_3, I_TRIG_4};
+
+    const unsigned nVoices = 1 << int(constrain(params_.voices.convertFrom0to1(params_.voices.getValue()), 0.0f, 2.0f));
+    // poly voices are allocated from midi notes, or have their own voct/trig inputs
+    const bool midiVoices = nVoices > 1 && noteInput_;
+    const float outGain = 1.0f / (32768.f * sqrtf(float(nVoices)));
+    const unsigned idleHold = unsigned(IDLE_HOLD * getSampleRate());
+
+    unsigned rd = noteRd_.load(std::memory_order_relaxed);
+    unsigned wr = noteWr_.load(std::memory_order_acquire);
+    for (; rd != wr; rd++) {
+        auto &e = noteQueue_[rd % MAX_NOTE_EVENTS];
+        if (midiVoices) noteEvent(e.note, e.velocity, nVoices);
+    }
+    noteRd_.store(rd, std::memory_order_release);
+
     for (int bidx = 0; bidx < buffer.getNumSamples(); bidx += n) {
-        bool trig = false;
-        for (int i = 0; i < n; i++) {
-            bool t = buffer.getSample(I_TRIG, bidx + i) > 0.5;
-            if (t != trig_ && t) {
-                trig = true;
+        for (unsigned v = 0; v < nVoices; v++) {
+            auto &vs = voiceState_[v];
+            if (midiVoices) continue;
+            const float *trigBuf = buffer.getReadPointer(trigIn[v], bidx);
+            for (int i = 0; i < n; i++) {
+                bool t = trigBuf[i] > 0.5;
+                if (t != vs.trig && t) {
+                    vs.trigPending = true;
+                }
+                vs.trig = t;
             }
-            trig_ = t;
         }
 
         // static constexpr float PltsPitchOffset = 60.0f - 3.044f;
         static constexpr float PltsPitchOffset = 60.0f;
         float pitch =
             params_.pitch.convertFrom0to1(params_.pitch.getValue())
-            + (noteInput_ ? noteInputTranspose_ : 0.0f);
+            + (noteInput_ && !midiVoices ? noteInputTranspose_ : 0.0f);
 
         patch_.engine = (int) constrain(params_.model.convertFrom0to1(params_.model.getValue()),
                                         0.0f, PltsMaxEngine);
@@ -153,44 +224,74 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
         patch_.timbre_modulation_amount = (params_.timbre_mod.getValue() * 2.0f) - 1.0f;
         patch_.morph_modulation_amount = (params_.morph_mod.getValue() * 2.0f) - 1.0f;
 
-        // Construct modulations
+        // Construct modulations, shared by all voices
         plaits::Modulations modulations{};
         modulations.engine = buffer.getSample(I_MODEL, bidx);
-        modulations.note = cv2Pitch(buffer.getSample(I_VOCT, bidx));
         modulations.frequency = cv2Pitch(buffer.getSample(I_FM, bidx));
         modulations.harmonics = buffer.getSample(I_HARMONICS, bidx);
         modulations.timbre = buffer.getSample(I_TIMBRE, bidx) * 0.625f;
         modulations.morph = buffer.getSample(I_MORPH, bidx) * 0.625f;
-
-        modulations.trigger = trig;
         modulations.level = buffer.getSample(I_LEVEL, bidx) * 0.625f;
 
         // modulations.frequency_patched = voctEn;
         modulations.frequency_patched = fmEn;
         modulations.timbre_patched = timbreEn;
         modulations.morph_patched = morphEn;
-        modulations.trigger_patched = trigEn;
         modulations.level_patched = levelEn;
 
+        float note = cv2Pitch(buffer.getSample(I_VOCT, bidx));
+
         // Render frames
-        plaits::Voice::Frame output[PltsBlock];
-        voice_.Render(patch_, modulations, output, PltsBlock);
+        float out[PltsBlock] = {}, aux[PltsBlock] = {};
+        for (unsigned v = 0; v < nVoices; v++) {
+            auto &vs = voiceState_[v];
+            bool trigEn = midiVoices || inputEnabled[trigIn[v]];
+            bool trig = vs.trigPending;
+            vs.trigPending = false;
+            // with level patched, the lpg opens from level cv without a trigger, so never idle
+            bool canIdle = trigEn && !levelEn;
+
+            if (trig || !canIdle) {
+                vs.idle = false;
+                vs.silentSamples = 0;
+            }
+            if (vs.idle) continue;
 
-        if (auxOut) {
+            plaits::Patch patch = patch_;
+            if (midiVoices) patch.note += vs.noteTranspose;
+
+            // voices without their own voct input follow the first
+            plaits::Modulations voiceMod = modulations;
+            voiceMod.note = (v > 0 && inputEnabled[voctIn[v]]) ? cv2Pitch(buffer.getSample(voctIn[v], bidx)) : note;
+            voiceMod.trigger = trig;
+            voiceMod.trigger_patched = trigEn;
+
+            plaits::Voice::Frame output[PltsBlock];
+            voices_[v].Render(patch, voiceMod, output, PltsBlock);
+
+            int peak = 0;
             for (int i = 0; i < PltsBlock; i++) {
-                buffer.setSample(O_OUT, bidx + i, output[i].out / 32768.f);
-                buffer.setSample(O_AUX, bidx + i, output[i].aux / 32768.f);
+                out[i] += output[i].out;
+                aux[i] += output[i].aux;
+                peak = std::max(peak, std::max(std::abs(int(output[i].out)), std::abs(int(output[i].aux))));
             }
-        } else {
-            for (int i = 0; i < PltsBlock; i++) {
-                buffer.setSample(O_OUT, bidx + i, output[i].out / 32768.f);
+
+            // a triggered lpg that has decayed to (1 lsb of) silence
+            if (canIdle && peak <= 1) {
+                vs.silentSamples += PltsBlock;
+                if (vs.silentSamples >= idleHold) vs.idle = true;
+            } else {
+                vs.silentSamples = 0;
             }
-            buffer.clear(O_AUX, 0, n);
         }
-    }
 
-    outRms_[0].process(buffer, O_OUT);
-    if (auxOut) outRms_[1].process(buffer, O_AUX);
+        FloatVectorOperations::copyWithMultiply(buffer.getWritePointer(O_OUT, bidx), out, outGain, n);
+        if (auxOut) {
+            FloatVectorOperations::copyWithMultiply(buffer.getWritePointer(O_AUX, bidx), aux, outGain, n);
+        } else {
+            buffer.clear(O_AUX, bidx, n);
+        }
+    }
 }
 
 AudioProcessorEditor *PluginProcessor::createEditor() {
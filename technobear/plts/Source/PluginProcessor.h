@@ -5,7 +5,6 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "ssp/BaseProcessor.h"
-#include "ssp/RmsTrack.h"
 
 #include <atomic>
 #include <algorithm>
@@ -36,6 +35,7 @@ PARAMETER_ID (timbre_mod)
 PARAMETER_ID (morph_mod)
 PARAMETER_ID (lpg)
 PARAMETER_ID (vca)
+PARAMETER_ID (voices)
 #undef PARAMETER_ID
 }
 
@@ -50,7 +50,7 @@ public:
 
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -70,11 +70,12 @@ public:
         Parameter& morph_mod;
         Parameter& lpg;
         Parameter& vca;
+        Parameter& voices;
     } params_;
 
     void getRMS(float &lOut, float &rOut) {
-        lOut = outRms_[0].lvl();
-        rOut = outRms_[1].lvl();
+        lOut = outputLevel(O_OUT).peak;
+        rOut = outputLevel(O_AUX).peak;
     }
 
     static BusesProperties getBusesProperties() {
@@ -90,7 +91,7 @@ public:
 
 protected:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    void midiNoteInput(unsigned note, unsigned velocity) override { if (velocity > 0) noteInputTranspose_ = float(note) - 60.f; }
+    void midiNoteInput(unsigned note, unsigned velocity) override;
 
 private:
     enum {
@@ -102,6 +103,12 @@ private:
         I_MORPH,
         I_FM,
         I_MODEL,
+        I_VOCT_2,
+        I_TRIG_2,
+        I_VOCT_3,
+        I_TRIG_3,
+        I_VOCT_4,
+        I_TRIG_4,
 
         I_MAX
     };
@@ -120,13 +127,37 @@ private:
 
     static constexpr unsigned PltsBlock = 16;
     static constexpr float PltsMaxEngine = 15.0f;
-    plaits::Voice voice_;
+    static constexpr unsigned MAX_VOICES = 4;
+    static constexpr unsigned VOICE_ARENA = 16384;
+    plaits::Voice voices_[MAX_VOICES];
     plaits::Patch patch_{};
-    char shared_buffer_[16384]{};
+    // one pool, a VOICE_ARENA slice per voice
+    char shared_buffer_[VOICE_ARENA * MAX_VOICES]{};
+
+    // voice is not rendered once its (triggered) lpg has decayed, until next trigger
+    static constexpr float IDLE_HOLD = 0.05f; // seconds
+    struct VoiceState {
+        float trig = 0.0f;
+        bool trigPending = false;
+        float noteTranspose = 0.0f;
+        bool held = false;
+        unsigned age = 0;
+        bool idle = false;
+        unsigned silentSamples = 0;
+    } voiceState_[MAX_VOICES];
+    unsigned allocCount_ = 0;
+
+    // midi notes, from midi thread to audio thread (single producer/consumer)
+    static constexpr unsigned MAX_NOTE_EVENTS = 32;
+    struct NoteEvent {
+        uint8 note;
+        uint8 velocity;
+    } noteQueue_[MAX_NOTE_EVENTS];
+    std::atomic<unsigned> noteWr_{0};
+    std::atomic<unsigned> noteRd_{0};
+
+    void noteEvent(unsigned note, unsigned velocity, unsigned nVoices);
 
-    ssp::RmsTrack outRms_[2];
-
-    float trig_ =0.0f;
     float noteInputTranspose_ = 0.0f;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
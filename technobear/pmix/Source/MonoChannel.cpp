@@ -14,7 +14,7 @@ void MonoChannel::paint(Graphics &g) {
     static constexpr int fh = 16;
     int w = getWidth();
 
-    float lvl = data_->rms_.lvl();
+    float lvl = data_->lvl();
     vuMeter_.level(lvl);
     vuMeter_.gainLevel(normValue(data_->level[0]));
 
@@ -42,6 +42,7 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)) {
     init();
+    for (unsigned i = 0; i < O_MAX; i++) fadeOnStateLoad(i);
     initTracks();
 }
 
@@ -159,23 +160,15 @@ void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     inputBuffers_.setSize(I_MAX, samplesPerBlock);
     outputBuffers_.setSize(O_MAX, samplesPerBlock);
 
-    // reset the RMS
-    for (unsigned ich = 0; ich < I_MAX; ich++) {
-        auto &d = *inTracks_[ich];
-        d.rms_.clear();
-    }
-
-    for (unsigned och = 0; och < O_MAX; och++) {
-        auto &d = *outTracks_[och];
-        d.rms_.clear();
-    }
+    inTrackMeters_.reset();
+    outTrackMeters_.reset();
 }
 
 inline float normValue(RangedAudioParameter &p) {
     return p.convertFrom0to1(p.getValue());
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned n = buffer.getNumSamples();
     bool insoloed = false;
     bool outsoloed = false;
@@ -189,12 +182,12 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
         outputBuffers_.applyGain(och, 0, n, 0.0f);
     }
 
+    const float *inLevels[I_MAX];
     for (unsigned ich = 0; ich < I_MAX; ich++) {
         bool inEnabled = inputEnabled[ich];
         if (!inEnabled) {
-            auto &inTrack = *inTracks_[ich];
-            // zero rms
-            inTrack.rms_.process(0.0f);
+            // zero level
+            inLevels[ich] = nullptr;
             continue;
         }
 
@@ -218,7 +211,7 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
             }
         }
         auto inbuf = inputBuffers_.getReadPointer(ich);
-        inTrack.rms_.process(inputBuffers_, ich);
+        inLevels[ich] = inbuf;
 
         for (unsigned o = 0; o < TrackData::OUT_TRACKS; o++) {
             bool outEnabled = outputEnabled[o * 2] || outputEnabled[o * 2 + 1];
@@ -261,13 +254,15 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
         // since we need to take care for source of input
     }
 
+    inTrackMeters_.process(inLevels, I_MAX, n, float(getSampleRate()));
+
     // calc output levels, and copy to vst buffer
+    const float *outLevels[O_MAX];
     for (int och = 0; och < O_MAX; och++) {
         bool outEnabled = outputEnabled[och];
         if (!outEnabled) {
-            // zero rms
-            auto &trk = *outTracks_[och];
-            trk.rms_.process(0.0f);
+            // zero level
+            outLevels[och] = nullptr;
             // zero output
             buffer.applyGain(och, 0, n, 0.0f);
             continue;
@@ -278,7 +273,7 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
         auto &ltrk = *outTracks_[outLead];
         bool outMuted = ltrk.mute.getValue() || (outsoloed && !ltrk.solo.getValue());
 
-        trk.rms_.process(outputBuffers_, och);
+        outLevels[och] = outputBuffers_.getReadPointer(och);
 
         if (!outMuted) {
             auto buf = outputBuffers_.getReadPointer(och);
@@ -287,6 +282,7 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
             buffer.applyGain(och, 0, n, 0.0f);
         }
     }
+    outTrackMeters_.process(outLevels, O_MAX, n, float(getSampleRate()));
 }
 
 AudioProcessorEditor *PluginProcessor::createEditor() {
@@ -301,9 +297,11 @@ AudioProcessor *JUCE_CALLTYPE createPluginFilter() {
 void PluginProcessor::initTracks() {
     for (unsigned i = 0; i < IN_T_MAX; i++) {
         inTracks_.push_back(std::make_unique<TrackData>(vts(), ID::in, i));
+        inTracks_[i]->meter(&inTrackMeters_, i);
     }
     for (unsigned i = 0; i < OUT_T_MAX; i++) {
         outTracks_.push_back(std::make_unique<TrackData>(vts(), ID::out, i));
+        outTracks_[i]->meter(&outTrackMeters_, i);
     }
 
 //    for (unsigned ich = 0; ich < I_MAX; ich++) {
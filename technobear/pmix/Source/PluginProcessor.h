@@ -4,7 +4,7 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "ssp/BaseProcessor.h"
-#include "ssp/RmsTrack.h"
+#include "ssp/Meters.h"
 
 #include <atomic>
 #include <algorithm>
@@ -51,7 +51,14 @@ struct TrackData {
     void init() {
         dummy_ = false;
         follows_ = 0;
-        rms_.clear();
+    }
+
+    // level, from processor meters
+    float lvl() const { return meters_ != nullptr ? meters_->level(meterCh_).peak : 0.0f; }
+
+    void meter(const ssp::Meters *meters, unsigned ch) {
+        meters_ = meters;
+        meterCh_ = ch;
     }
 
     static constexpr unsigned OUT_TRACKS = 4;
@@ -72,7 +79,8 @@ struct TrackData {
     unsigned follows_=0; // dummy
     // hpf/dc block
     float dcX1_ = 0.0f, dcY1_ = 0.0f;
-    ssp::RmsTrack rms_;
+    const ssp::Meters *meters_ = nullptr;
+    unsigned meterCh_ = 0;
 };
 
 
@@ -86,7 +94,7 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -169,6 +177,8 @@ private:
     void initTracks();
     AudioSampleBuffer inputBuffers_;
     AudioSampleBuffer outputBuffers_;
+    // track levels, after gain/ac (inputs) and before mute (outputs)
+    ssp::Meters inTrackMeters_, outTrackMeters_;
 
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
@@ -14,7 +14,7 @@ void StereoChannel::paint(Graphics &g) {
     int h = getHeight();
     int w = getWidth();
 
-    vuMeter_.level(lData_->rms_.lvl(), rData_->rms_.lvl());
+    vuMeter_.level(lData_->lvl(), rData_->lvl());
 
     float gl=normValue(lData_->level[0]);
     float gr=normValue(rData_->level[0]);
@@ -29,7 +29,7 @@ void StereoChannel::paint(Graphics &g) {
     bool mute = lData_->mute.getValue();
     bool solo = lData_->solo.getValue();
     float pan = normValue(lData_->pan);
-    float lvl = lData_->rms_.lvl();
+    float lvl = lData_->lvl();
 
     int y = vuMeter_.getHeight();
     y += 5;
@@ -26,6 +26,13 @@ PluginEditor::PluginEditor(PluginProcessor &p)
         std::make_shared<pcontrol_type>(processor_.params_.in_gain)
     );
 
+    addParamPage(
+        std::make_shared<pcontrol_type>(processor_.params_.block, 1.0f, 1.0f),
+        nullptr,
+        nullptr,
+        nullptr
+    );
+
 
     inVu_.init("In");
     outVu_.init("Out");
@@ -49,6 +56,14 @@ void PluginEditor::drawView(Graphics &g) {
     outVu_.level(outL, outR);
 
     base_type::drawView(g);
+
+    // strums since silence, not measured per voice, so shown as an estimate
+    unsigned estimated, polyphony;
+    processor_.getEstimatedVoices(estimated, polyphony);
+    g.setFont(20);
+    g.setColour(estimated > 0 ? Colours::lightskyblue : Colours::grey);
+    g.drawText("Est. voices " + String(estimated) + "/" + String(polyphony), 1400, 200, 200, 30,
+               Justification::centredLeft);
 }
 
 
@@ -17,12 +17,11 @@ PluginProcessor::PluginProcessor(
 
     inLevel_ = 0.0f;
 
-    io_buf_sz_ = RingsBlock;
+    io_buf_sz_ = MaxBlock;
     in_buf_ = new float[io_buf_sz_];
-    out_buf_ = new float[io_buf_sz_];
     aux_buf_ = new float[io_buf_sz_];
+    gate_buf_ = new float[io_buf_sz_];
 
-    strummer_.Init(0.01f, 48000 / RingsBlock);
     string_synth_.Init(buffer);
     part_.Init(buffer);
     initPart(true);
@@ -30,11 +29,11 @@ PluginProcessor::PluginProcessor(
 
 PluginProcessor::~PluginProcessor() {
     delete[] in_buf_;
-    delete[] out_buf_;
     delete[] aux_buf_;
+    delete[] gate_buf_;
     in_buf_ = nullptr;
-    out_buf_ = nullptr;
     aux_buf_ = nullptr;
+    gate_buf_ = nullptr;
 }
 
 
@@ -48,7 +47,8 @@ PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt)
     model(*apvt.getParameter(ID::model)),
     //bypass(*apvt.getParameter(ID::bypass)),
     //easter_egg(*apvt.getParameter(ID::easter_egg)),
-    in_gain(*apvt.getParameter(ID::in_gain)) {
+    in_gain(*apvt.getParameter(ID::in_gain)),
+    block(*apvt.getParameter(ID::block)) {
 }
 
 
@@ -79,6 +79,8 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
 //    params.add(std::make_unique<ssp::BaseBoolParameter>(ID::bypass, "bypass", false));
 //    params.add(std::make_unique<ssp::BaseBoolParameter>(ID::easter_egg, "easter_egg", false));
     params.add(std::make_unique<ssp::BaseFloatParameter>(ID::in_gain, "In Gain", 0.0f, 100.0f, 0.0f));
+    // added after in_gain, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::block, "Block", StringArray{"16", "32", "64"}, 0));
     return params;
 }
 
@@ -110,14 +112,24 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     BaseProcessor::prepareToPlay(sampleRate, samplesPerBlock);
-    strummer_.Init(0.01f, sampleRate / RingsBlock);
     string_synth_.Init(buffer);
     part_.Init(buffer);
 
     initPart(true);
 }
 
+void PluginProcessor::audioProcessorParameterChanged(AudioProcessor *p, int parameterIndex, float newValue) {
+    BaseProcessor::audioProcessorParameterChanged(p, parameterIndex, newValue);
+    if (parameterIndex == params_.polyphony.getParameterIndex()
+        || parameterIndex == params_.model.getParameterIndex()
+        || parameterIndex == params_.block.getParameterIndex()) {
+        partDirty_ = true;
+    }
+}
+
 void PluginProcessor::initPart(bool force) {
+    partDirty_ = false;
+
     int polyphony = constrain(
         1 << int(params_.polyphony.convertFrom0to1(params_.polyphony.getValue())),
         1, rings::kMaxPolyphony);
@@ -134,29 +146,58 @@ void PluginProcessor::initPart(bool force) {
         part_.set_model(model);
         string_synth_.set_fx(static_cast<rings::FxType>(model));
     }
+
+    unsigned block = constrain(RingsBlock << int(params_.block.convertFrom0to1(params_.block.getValue())),
+                               RingsBlock, MaxBlock);
+    if (force || block != controlBlock_) {
+        controlBlock_ = block;
+        // strummer runs at control rate
+        float sampleRate = getSampleRate() > 0.0 ? float(getSampleRate()) : 48000.0f;
+        strummer_.Init(0.01f, sampleRate / float(controlBlock_));
+    }
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
-    auto n = RingsBlock;
-    size_t size = n;
+void PluginProcessor::noiseGate(float *buf, unsigned n) {
+    // level follower is recursive so runs per sample, squaring and gain are vectorised
+    FloatVectorOperations::multiply(gate_buf_, buf, buf, n);
+    float level = inLevel_;
+    for (unsigned i = 0; i < n; i++) {
+        float error = gate_buf_[i] - level;
+        level += error * (error > 0.0f ? 0.1f : 0.0001f);
+        gate_buf_[i] = level;
+    }
+    inLevel_ = level;
+
+    // gain = level / threshold, when level is below threshold
+    FloatVectorOperations::multiply(gate_buf_, 1.0f / kNoiseGateThreshold, n);
+    FloatVectorOperations::min(gate_buf_, gate_buf_, 1.0f, n);
+    FloatVectorOperations::multiply(buf, gate_buf_, n);
+}
+
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+    if (partDirty_) initPart(false);
+
+    const unsigned n = controlBlock_;
+    const unsigned sz = buffer.getNumSamples();
 
-    inRms_.process(buffer, I_IN);
     bool stereoOut = outputEnabled[O_EVEN];
 
     float p_in_gain = params_.in_gain.getValue();
+    float gain = (p_in_gain * 4.0f);
+    float in_gain = constrain(1.0f + (gain * gain), 1.0f, 17.0f);
 
     // Rings usually has a blocks size of 16,
-    // SSP = 128 (@48k), so split up, so we read the control rate date every 16
-    for (int bidx = 0; bidx < buffer.getNumSamples(); bidx += n) {
+    // SSP = 128 (@48k), so split up, so we read the control rate date every control block
+    // note: outputs share channels with In and Strum, so these are read before Part writes to them
+    for (unsigned bidx = 0; bidx < sz; bidx += n) {
+        const unsigned len = std::min(n, sz - bidx);
 
-
-        float gain = (p_in_gain * 4.0f);
-        float in_gain = constrain(1.0f + (gain * gain), 1.0f, 17.0f);
+        FloatVectorOperations::copyWithMultiply(in_buf_, buffer.getReadPointer(I_IN, bidx), in_gain, len);
 
         bool strum = false;
-        for (int i = 0; i < n; i++) {
-            in_buf_[i] = out_buf_[i] = buffer.getSample(I_IN, bidx + i) * in_gain;
-            bool trig = buffer.getSample(I_STRUM, bidx + i) > 0.5;
+        const float *strumIn = buffer.getReadPointer(I_STRUM, bidx);
+        for (unsigned i = 0; i < len; i++) {
+            bool trig = strumIn[i] > 0.5;
             if (trig != trig_ && trig) {
                 strum = true;
             }
@@ -200,49 +241,75 @@ void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMe
 
         performance_state_.strum = strum;
 
-        initPart(false);
-
         bool bypass = false; //params_.bypass.getValue() > 0.5;
         part_.set_bypass(bypass);
         bool easter_egg = false; //params_.easter_egg.getValue() > 0.5;
 
         if (easter_egg) {
-            strummer_.Process(NULL, size, &(performance_state_));
-            string_synth_.Process(performance_state_, patch_, in_buf_, out_buf_, aux_buf_, size);
+            strummer_.Process(NULL, len, &(performance_state_));
         } else {
-            // Apply noise gate.
-            for (size_t i = 0; i < size; ++i) {
-                float in_sample = in_buf_[i];
-                float error, gain;
-                error = in_sample * in_sample - inLevel_;
-                inLevel_ += error * (error > 0.0f ? 0.1f : 0.0001f);
-                gain = inLevel_ <= kNoiseGateThreshold
-                       ? (1.0f / kNoiseGateThreshold) * inLevel_ : 1.0f;
-                in_buf_[i] = gain * in_sample;
+            noiseGate(in_buf_, len);
+            strummer_.Process(in_buf_, len, &(performance_state_));
+        }
+
+        // render straight into the output channels, aux into a work buffer if mixing down to mono
+        float *out = buffer.getWritePointer(O_ODD, bidx);
+        float *aux = stereoOut ? buffer.getWritePointer(O_EVEN, bidx) : aux_buf_;
+
+        // idle part, wakes on strum or (external exciter) input above the noise gate
+        if (performance_state_.strum) strumCount_++;
+        bool excited = performance_state_.strum
+                       || (!performance_state_.internal_exciter && inLevel_ > kNoiseGateThreshold);
+        if (excited || easter_egg) {
+            partIdle_ = false;
+            silentSamples_ = 0;
+        }
+        if (partIdle_) {
+            FloatVectorOperations::clear(out, len);
+            if (stereoOut) FloatVectorOperations::clear(aux, len);
+            continue;
+        }
+
+        for (unsigned c = 0; c < len; c += RingsBlock) {
+            size_t csz = std::min(RingsBlock, len - c);
+            if (easter_egg) {
+                string_synth_.Process(performance_state_, patch_, in_buf_ + c, out + c, aux + c, csz);
+            } else {
+                part_.Process(performance_state_, patch_, in_buf_ + c, out + c, aux + c, csz);
             }
-            strummer_.Process(in_buf_, size, &(performance_state_));
-            part_.Process(performance_state_, patch_, in_buf_, out_buf_, aux_buf_, size);
+            // strum once per control block
+            performance_state_.strum = false;
         }
 
-        if (stereoOut) {
-            for (int i = 0; i < RingsBlock; i++) {
-                buffer.setSample(O_ODD, bidx + i, out_buf_[i]);
-                buffer.setSample(O_EVEN, bidx + i, aux_buf_[i]);
+        auto outRange = FloatVectorOperations::findMinAndMax(out, len);
+        auto auxRange = FloatVectorOperations::findMinAndMax(aux, len);
+        float peak = std::max(std::max(-outRange.getStart(), outRange.getEnd()),
+                              std::max(-auxRange.getStart(), auxRange.getEnd()));
+        if (peak < kSilence) {
+            silentSamples_ += len;
+            if (silentSamples_ >= unsigned(kIdleHold * getSampleRate())) {
+                partIdle_ = true;
+                strumCount_ = 0;
             }
         } else {
-            for (int i = 0; i < RingsBlock; i++) {
-                buffer.setSample(O_ODD, bidx + i, (out_buf_[i] + aux_buf_[i]) / 2.0f);
-            }
+            silentSamples_ = 0;
+        }
+
+        if (!stereoOut) {
+            FloatVectorOperations::add(out, aux_buf_, len);
+            FloatVectorOperations::multiply(out, 0.5f, len);
         }
     }
 
-    outRms_[0].process(buffer, O_ODD);
-    if (stereoOut) outRms_[1].process(buffer, O_EVEN);
+    unsigned polyphony = part_.polyphony();
+    polyphony_ = polyphony;
+    estimatedVoices_ = partIdle_ ? 0 : std::min(std::max(strumCount_, 1u), polyphony);
 }
 
 void PluginProcessor::setStateInformation(const void *data, int sizeInBytes) {
     ssp::BaseProcessor::setStateInformation(data, sizeInBytes);
-    initPart(true);
+    // picked up by the audio thread
+    partDirty_ = true;
 }
 
 
@@ -9,7 +9,6 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "ssp/BaseProcessor.h"
-#include "ssp/RmsTrack.h"
 
 #include <atomic>
 #include <algorithm>
@@ -27,6 +26,7 @@ PARAMETER_ID (model)
 //PARAMETER_ID (bypass)
 //PARAMETER_ID (easter_egg)
 PARAMETER_ID (in_gain)
+PARAMETER_ID (block)
 #undef PARAMETER_ID
 }
 
@@ -41,7 +41,7 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -61,12 +61,19 @@ public:
         //Parameter&  bypass;
         //Parameter&  easter_egg;
         Parameter &in_gain;
+        Parameter &block;
     } params_;
 
     void getRMS(float &in, float &lOut, float &rOut) {
-        in = inRms_.lvl();
-        lOut = outRms_[0].lvl();
-        rOut = outRms_[1].lvl();
+        in = inputLevel(I_IN).peak;
+        lOut = outputLevel(O_ODD).peak;
+        rOut = outputLevel(O_EVEN).peak;
+    }
+
+    // estimate of voices in use, strums since the part was last silent (capped at polyphony), not measured output
+    void getEstimatedVoices(unsigned &estimated, unsigned &polyphony) {
+        estimated = estimatedVoices_;
+        polyphony = polyphony_;
     }
 
     void setStateInformation(const void *data, int sizeInBytes) override;
@@ -85,8 +92,13 @@ public:
 protected:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // loaded synchronously, the part is then re-initialised at the start of the next block
+    bool asyncStateLoad() override { return false; }
+
     void midiNoteInput(unsigned note, unsigned velocity) override { if (velocity > 0) noteInputTranspose_ = float(note) - 60.f; }
 
+    void audioProcessorParameterChanged(AudioProcessor *p, int parameterIndex, float newValue) override;
+
 private:
     enum {
         I_IN,
@@ -114,8 +126,14 @@ private:
     static const String getOutputBusName(int channelIndex);
 
     void initPart(bool force);
+    void noiseGate(float *buf, unsigned n);
 
+    // Part::Process is called with (at most) RingsBlock samples, its internal buffers are kMaxBlockSize
+    // controls are read once per control block, RingsBlock to MaxBlock
     static constexpr unsigned RingsBlock = 16;
+    static constexpr unsigned MaxBlock = RingsBlock * 4;
+    unsigned controlBlock_ = RingsBlock;
+    std::atomic<bool> partDirty_{true};
 
     rings::Part part_;
     rings::PerformanceState performance_state_;
@@ -126,14 +144,21 @@ private:
     static constexpr float kNoiseGateThreshold = 0.00003f;
     float inLevel_;
 
-    float *in_buf_, *out_buf_, *aux_buf_;
+    // part is not rendered once its output has decayed, until the next strum or input
+    static constexpr float kSilence = 1e-5f;
+    static constexpr float kIdleHold = 0.1f; // seconds
+    bool partIdle_ = false;
+    unsigned silentSamples_ = 0;
+    unsigned strumCount_ = 0;
+    std::atomic<unsigned> estimatedVoices_{0};
+    std::atomic<unsigned> polyphony_{1};
+
+    float *in_buf_, *aux_buf_, *gate_buf_;
     int io_buf_sz_;
 
     static const int REVERB_SZ = 32768;
     uint16_t buffer[REVERB_SZ];
 
-    ssp::RmsTrack inRms_;
-    ssp::RmsTrack outRms_[2];
     bool trig_;
     float noteInputTranspose_ = 0.0f;
 
@@ -0,0 +1,149 @@
+// offline driver for the real time safety check (SSP_RT_CHECK), see common/ssp/RtCheck.h
+// loads a plugin as the SSP does, then runs process for a number of blocks, with signals on every input
+// reloading its state half way through, so the background state load is exercised too
+// run with SSP_RT_CHECK_ABORT=1, so any violation fails (aborts) the run
+//
+// with --bench, it instead feeds an impulse on every input followed by silence (a decaying tail)
+// and reports dsp load (block time / block duration) mean and max, with denormals flushed (as processBlock does)
+// and again with them kept (SSP_KEEP_DENORMALS), to show what flushing saves
+//
+// usage : ssp-rtcheck [--bench] plugin.so [blocks]
+
+#include "../../ssp-sdk/Percussa.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <dlfcn.h>
+
+using namespace Percussa::SSP;
+
+static constexpr double SAMPLE_RATE = 48000.0;
+static constexpr int BLOCK_SIZE = 128;
+static constexpr int DEFAULT_BLOCKS = 2000;
+static constexpr int DEFAULT_BENCH_BLOCKS = 22500; // 60 seconds, long enough for tails to decay to denormals
+
+using CreateInstanceFn = PluginInterface *(*)();
+
+// impulse on every input, then silence, returns load as a fraction of the block duration
+static void bench(CreateInstanceFn createInstance, unsigned nIn, unsigned nOut, unsigned nCh, int blocks,
+                  float &mean, float &max) {
+    PluginInterface *plugin = createInstance();
+    plugin->prepare(SAMPLE_RATE, BLOCK_SIZE);
+    for (unsigned i = 0; i < nIn; i++) plugin->inputEnabled(int(i), true);
+    for (unsigned i = 0; i < nOut; i++) plugin->outputEnabled(int(i), true);
+
+    std::vector<std::vector<float>> data(nCh, std::vector<float>(BLOCK_SIZE, 0.0f));
+    std::vector<float *> channels;
+    for (auto &d: data) channels.push_back(d.data());
+
+    const double budget = double(BLOCK_SIZE) / SAMPLE_RATE;
+    double sum = 0.0;
+    max = 0.0f;
+    for (int b = 0; b < blocks; b++) {
+        for (unsigned c = 0; c < nCh; c++) {
+            std::fill(data[c].begin(), data[c].end(), 0.0f);
+            if (b == 0 && c < nIn) data[c][0] = 1.0f;
+        }
+        auto start = std::chrono::steady_clock::now();
+        plugin->process(channels.data(), int(nCh), BLOCK_SIZE);
+        std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+
+        float load = float(t.count() / budget);
+        sum += load;
+        max = std::max(max, load);
+    }
+    mean = float(sum / double(blocks));
+    delete plugin;
+}
+
+int main(int argc, char **argv) {
+    bool benchMode = argc > 1 && strcmp(argv[1], "--bench") == 0;
+    if (benchMode) {
+        argc--;
+        argv++;
+    }
+    if (argc < 2) {
+        fprintf(stderr, "usage : %s [--bench] plugin.so [blocks]\n", argv[0]);
+        return 2;
+    }
+    int blocks = argc > 2 ? atoi(argv[2]) : (benchMode ? DEFAULT_BENCH_BLOCKS : DEFAULT_BLOCKS);
+
+    void *lib = dlopen(argv[1], RTLD_NOW | RTLD_LOCAL);
+    if (lib == nullptr) {
+        fprintf(stderr, "rtcheck : %s\n", dlerror());
+        return 2;
+    }
+
+    using CreateDescriptorFn = PluginDescriptor *(*)();
+    auto createDescriptor = reinterpret_cast<CreateDescriptorFn>(dlsym(lib, "createDescriptor"));
+    auto createInstance = reinterpret_cast<CreateInstanceFn>(dlsym(lib, "createInstance"));
+    if (createDescriptor == nullptr || createInstance == nullptr) {
+        fprintf(stderr, "rtcheck : %s is not an ssp plugin\n", argv[1]);
+        return 2;
+    }
+
+    PluginDescriptor *desc = createDescriptor();
+    unsigned nIn = unsigned(desc->inputChannelNames.size());
+    unsigned nOut = unsigned(desc->outputChannelNames.size());
+    unsigned nCh = std::max(std::max(nIn, nOut), 1u);
+
+    if (benchMode) {
+        // each instance reads SSP_KEEP_DENORMALS when prepared
+        float mean, max;
+        unsetenv("SSP_KEEP_DENORMALS");
+        bench(createInstance, nIn, nOut, nCh, blocks, mean, max);
+        fprintf(stdout, "bench : %s, %d blocks, denormals flushed : mean %.1f%% max %.1f%%\n",
+                desc->name.c_str(), blocks, mean * 100.0f, max * 100.0f);
+        setenv("SSP_KEEP_DENORMALS", "1", 1);
+        bench(createInstance, nIn, nOut, nCh, blocks, mean, max);
+        fprintf(stdout, "bench : %s, %d blocks, denormals kept    : mean %.1f%% max %.1f%%\n",
+                desc->name.c_str(), blocks, mean * 100.0f, max * 100.0f);
+        unsetenv("SSP_KEEP_DENORMALS");
+        delete desc;
+        return 0;
+    }
+
+    PluginInterface *plugin = createInstance();
+    plugin->prepare(SAMPLE_RATE, BLOCK_SIZE);
+    for (unsigned i = 0; i < nIn; i++) plugin->inputEnabled(int(i), true);
+    for (unsigned i = 0; i < nOut; i++) plugin->outputEnabled(int(i), true);
+
+    std::vector<std::vector<float>> data(nCh, std::vector<float>(BLOCK_SIZE, 0.0f));
+    std::vector<float *> channels;
+    for (auto &d: data) channels.push_back(d.data());
+
+    void *state = nullptr;
+    size_t stateSize = 0;
+    plugin->getState(&state, &stateSize);
+
+    for (int b = 0; b < blocks; b++) {
+        // audio rate sines on even inputs, 2hz gates on odd inputs (triggers, clocks)
+        for (unsigned c = 0; c < nCh; c++) {
+            for (int s = 0; s < BLOCK_SIZE; s++) {
+                double t = double(b * BLOCK_SIZE + s) / SAMPLE_RATE;
+                float v = 0.0f;
+                if (c < nIn) {
+                    v = (c & 1) ? (fmod(t * 2.0, 1.0) < 0.5 ? 1.0f : 0.0f)
+                                : 0.5f * float(sin(2.0 * M_PI * 110.0 * double(c + 1) * t));
+                }
+                data[c][s] = v;
+            }
+        }
+        plugin->process(channels.data(), int(nCh), BLOCK_SIZE);
+
+        if (b == blocks / 2 && state != nullptr) plugin->setState(state, stateSize);
+    }
+
+    fprintf(stdout, "rtcheck : %s, %d blocks, ok\n", desc->name.c_str(), blocks);
+
+    delete plugin;
+    delete[] static_cast<char *>(state);
+    delete desc;
+    return 0;
+}
@@ -107,7 +107,7 @@ float PluginProcessor::processCV(float v, unsigned scale, unsigned root) {
     return v;
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned n = buffer.getNumSamples();
 
     bool inTrigE[MAX_SIG];
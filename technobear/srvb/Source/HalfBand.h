@@ -0,0 +1,119 @@
+#pragma once
+
+#include "ssp/Float4.h"
+
+#include <cmath>
+#include <cstring>
+
+// halfband lowpass FIR (blackman windowed sinc), for 2x decimation and interpolation
+// of the 31 taps, only the centre tap and the 16 even taps are non zero, so each is
+// a 16 tap dot product (4 x float4) plus a delayed sample
+class HalfBandCoeffs {
+public:
+    static constexpr unsigned N_TAPS = 31;
+    static constexpr unsigned N_EVEN = (N_TAPS + 1) / 2;
+    // centre tap delay, in half rate samples
+    static constexpr unsigned DELAY = (N_EVEN / 2) - 1;
+
+    static const HalfBandCoeffs &get() {
+        static HalfBandCoeffs coeffs;
+        return coeffs;
+    }
+
+    // h[2j], summing to 0.5
+    const float *even() const { return even_; }
+
+private:
+    HalfBandCoeffs() {
+        const double c = double(N_TAPS - 1) / 2.0;
+        double sum = 0.0;
+        for (unsigned j = 0; j < N_EVEN; j++) {
+            double k = double(2 * j);
+            double x = (k - c) * 0.5;
+            double sinc = sin(M_PI * x) / (M_PI * x);
+            double w = 0.42 - (0.5 * cos(2.0 * M_PI * k / double(N_TAPS - 1)))
+                       + (0.08 * cos(4.0 * M_PI * k / double(N_TAPS - 1)));
+            double h = 0.5 * sinc * w;
+            even_[j] = float(h);
+            sum += h;
+        }
+        for (unsigned j = 0; j < N_EVEN; j++) {
+            even_[j] = float(double(even_[j]) * 0.5 / sum);
+        }
+    }
+
+    alignas(16) float even_[N_EVEN];
+};
+
+
+// history of a half rate stream, newest first, contiguous for the dot product
+class HalfBandHistory {
+public:
+    static constexpr unsigned N = HalfBandCoeffs::N_EVEN;
+
+    void reset() {
+        memset(buf_, 0, sizeof(buf_));
+        pos_ = 0;
+    }
+
+    inline void push(float v) {
+        pos_ = pos_ == 0 ? N - 1 : pos_ - 1;
+        buf_[pos_] = v;
+        buf_[pos_ + N] = v;
+    }
+
+    // sample pushed d pushes ago
+    inline float delayed(unsigned d) const { return buf_[pos_ + d]; }
+
+    inline float dot(const float *coeffs) const {
+        const float *x = buf_ + pos_;
+        ssp::float4 sum = ssp::float4::dup(0.0f);
+        for (unsigned i = 0; i < N; i += ssp::float4::N) {
+            // history is not aligned, so load lanes individually
+            alignas(16) float v[ssp::float4::N] = {x[i], x[i + 1], x[i + 2], x[i + 3]};
+            sum = ssp::float4::madd(sum, ssp::float4::load(v), ssp::float4::load(coeffs + i));
+        }
+        return sum.hsum();
+    }
+
+private:
+    float buf_[N * 2];
+    unsigned pos_ = 0;
+};
+
+
+// 2 samples in, 1 out
+class HalfBandDecimator {
+public:
+    void reset() {
+        even_.reset();
+        odd_.reset();
+    }
+
+    // x0 is the earlier sample
+    inline float process(float x0, float x1) {
+        odd_.push(x0);
+        even_.push(x1);
+        return even_.dot(HalfBandCoeffs::get().even()) + (0.5f * odd_.delayed(HalfBandCoeffs::DELAY));
+    }
+
+private:
+    HalfBandHistory even_, odd_;
+};
+
+
+// 1 sample in, 2 out
+class HalfBandInterpolator {
+public:
+    void reset() { hist_.reset(); }
+
+    // y0 is the earlier output sample
+    inline void process(float x, float &y0, float &y1) {
+        hist_.push(x);
+        y0 = 2.0f * hist_.dot(HalfBandCoeffs::get().even());
+        y1 = hist_.delayed(HalfBandCoeffs::DELAY);
+    }
+
+private:
+    HalfBandHistory hist_;
+};
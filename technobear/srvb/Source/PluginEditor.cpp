@@ -17,7 +17,7 @@ PluginEditor::PluginEditor(PluginProcessor &p)
         std::make_shared<pcontrol_type>(processor_.params_.mix),
         std::make_shared<pcontrol_type>(processor_.params_.feedback),
         std::make_shared<pcontrol_type>(processor_.params_.lpfreq, 100, 5),
-        nullptr
+        std::make_shared<pcontrol_type>(processor_.params_.quality, 1.0f, 1.0f)
     );
 
     addButtonPage(
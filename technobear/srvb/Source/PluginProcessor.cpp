@@ -15,6 +15,8 @@ PluginProcessor::PluginProcessor(
     AudioProcessorValueTreeState::ParameterLayout layout)
     : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
     init();
+    fadeOnStateLoad(O_LEFT);
+    fadeOnStateLoad(O_RIGHT);
 }
 
 PluginProcessor::~PluginProcessor() {
@@ -24,7 +26,8 @@ PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt)
     lpfreq(*apvt.getParameter(ID::lpfreq)),
     feedback(*apvt.getParameter(ID::feedback)),
     mix(*apvt.getParameter(ID::mix)),
-    freeze(*apvt.getParameter(ID::freeze)) {
+    freeze(*apvt.getParameter(ID::freeze)),
+    quality(*apvt.getParameter(ID::quality)) {
 }
 
 
@@ -36,6 +39,8 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     params.add(std::make_unique<ssp::BaseFloatParameter>(ID::feedback, "Feedback", 0.0f, 100.0f, 10.0f));
     params.add(std::make_unique<ssp::BaseFloatParameter>(ID::mix, "Mix", 0.0f, 100.0f, 50.0f));
     params.add(std::make_unique<ssp::BaseBoolParameter>(ID::freeze, "Freeze", false));
+    // added after freeze, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseChoiceParameter>(ID::quality, "Quality", StringArray{"Full", "Half"}, 0));
     return params;
 }
 
@@ -60,35 +65,119 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 }
 
 void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPerBlock) {
-    reverbSc_.Init(newSampleRate);
+    BaseProcessor::prepareToPlay(newSampleRate, estimatedSamplesPerBlock);
+    workBuf_.setSize(2, estimatedSamplesPerBlock);
+    initReverb(Quality(int(normValue(params_.quality))));
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
-    bool stereoIn = inputEnabled[O_RIGHT];
-    bool stereoOut = outputEnabled[O_RIGHT];
 
-    inRms_[0].process(buffer, I_LEFT);
-    if (stereoIn) inRms_[1].process(buffer, I_RIGHT);
+void PluginProcessor::initReverb(Quality q) {
+    quality_ = q;
+    float sr = float(getSampleRate());
+    reverbSc_.Init(quality_ == Q_HALF ? sr * 0.5f : sr);
+    for (unsigned c = 0; c < 2; c++) {
+        decimator_[c].reset();
+        interpolator_[c].reset();
+        halfIn_[c] = 0.0f;
+        halfOut_[c] = 0.0f;
+    }
+    halfPhase_ = false;
+    silentSamples_ = 0;
+    idle_ = false;
+}
+
+
+void PluginProcessor::processFull(const float *inL, const float *inR, float *wetL, float *wetR, unsigned sz) {
+    for (unsigned s = 0; s < sz; s++) {
+        reverbSc_.Process(inL[s], inR[s], wetL + s, wetR + s);
+    }
+}
+
+
+void PluginProcessor::processHalf(const float *inL, const float *inR, float *wetL, float *wetR, unsigned sz) {
+    for (unsigned s = 0; s < sz; s++) {
+        if (!halfPhase_) {
+            // first of pair, hold input, output second half of previous pair
+            halfIn_[0] = inL[s];
+            halfIn_[1] = inR[s];
+            wetL[s] = halfOut_[0];
+            wetR[s] = halfOut_[1];
+        } else {
+            float dl = decimator_[0].process(halfIn_[0], inL[s]);
+            float dr = decimator_[1].process(halfIn_[1], inR[s]);
+            float rl = 0.0f, rr = 0.0f;
+            reverbSc_.Process(dl, dr, &rl, &rr);
+            interpolator_[0].process(rl, wetL[s], halfOut_[0]);
+            interpolator_[1].process(rr, wetR[s], halfOut_[1]);
+        }
+        halfPhase_ = !halfPhase_;
+    }
+}
+
+
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+    unsigned sz = buffer.getNumSamples();
+    if (workBuf_.getNumSamples() < sz) workBuf_.setSize(2, sz, false, false, true);
+
     bool freeze = params_.freeze.getValue() > 0.5f;
     float mix = params_.mix.getValue();
     float imix = 1.0f - mix;
+
+    // at mix 0 the reverb is not run, its state is stale, so start clean rather than resume the old tail
+    bool muted = mix <= 0.0f;
+    Quality q = Quality(int(normValue(params_.quality)));
+    if (q != quality_ || (muted_ && !muted)) initReverb(q);
+    muted_ = muted;
+    float maxLpFreq = float(getSampleRate()) * (quality_ == Q_HALF ? 0.25f : 0.5f);
     reverbSc_.SetFeedback(freeze ? 1.0f : params_.feedback.getValue());
-    reverbSc_.SetLpFreq(normValue(params_.lpfreq));
+    reverbSc_.SetLpFreq(std::min(normValue(params_.lpfreq), maxLpFreq));
 
-    int sz = buffer.getNumSamples();
-    for (int s = 0; s < sz; s++) {
-        float ils = freeze ? 0.0f : buffer.getSample(I_LEFT, s);
-        float irs = freeze ? 0.0f : buffer.getSample(I_RIGHT, s);
-        float ols = 0.0f, ors = 0.0f;
-        reverbSc_.Process(ils, irs, &ols, &ors);
+    float *outL = buffer.getWritePointer(O_LEFT);
+    float *outR = buffer.getWritePointer(O_RIGHT);
 
-        buffer.setSample(O_LEFT, s, (ils * imix) + (ols * mix));
-        buffer.setSample(O_RIGHT, s, (irs * imix) + (ors * mix));
+    if (freeze) {
+        // frozen, input is not fed to the reverb, nor passed dry
+        buffer.clear(I_LEFT, 0, sz);
+        buffer.clear(I_RIGHT, 0, sz);
     }
 
-    outRms_[0].process(buffer, O_LEFT);
-    if (stereoOut) outRms_[1].process(buffer, O_RIGHT);
+    // wake on input, sleep once input and tail have been silent long enough
+    bool inputSilent = buffer.getMagnitude(I_LEFT, 0, sz) < SILENCE
+                       && buffer.getMagnitude(I_RIGHT, 0, sz) < SILENCE;
+    if (!inputSilent) {
+        idle_ = false;
+        silentSamples_ = 0;
+    }
 
+    if (idle_ || muted) {
+        // nothing to add, output is the dry signal (in place)
+        buffer.applyGain(O_LEFT, 0, sz, imix);
+        buffer.applyGain(O_RIGHT, 0, sz, imix);
+    } else {
+        const float *inL = buffer.getReadPointer(I_LEFT);
+        const float *inR = buffer.getReadPointer(I_RIGHT);
+        float *wetL = workBuf_.getWritePointer(0);
+        float *wetR = workBuf_.getWritePointer(1);
+        if (quality_ == Q_HALF) {
+            processHalf(inL, inR, wetL, wetR, sz);
+        } else {
+            processFull(inL, inR, wetL, wetR, sz);
+        }
+
+        bool tailSilent = workBuf_.getMagnitude(0, 0, sz) < SILENCE && workBuf_.getMagnitude(1, 0, sz) < SILENCE;
+        if (inputSilent && tailSilent) {
+            silentSamples_ += sz;
+            idle_ = silentSamples_ > unsigned(TAIL_HOLD * getSampleRate());
+        } else {
+            silentSamples_ = 0;
+        }
+
+        // in/out share channels, dry is scaled in place, then wet added
+        FloatVectorOperations::multiply(outL, imix, sz);
+        FloatVectorOperations::multiply(outR, imix, sz);
+        FloatVectorOperations::addWithMultiply(outL, wetL, mix, sz);
+        FloatVectorOperations::addWithMultiply(outR, wetR, mix, sz);
+    }
 }
 
 AudioProcessorEditor *PluginProcessor::createEditor() {
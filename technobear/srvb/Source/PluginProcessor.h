@@ -3,13 +3,14 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "ssp/BaseProcessor.h"
-#include "ssp/RmsTrack.h"
 
 #include <atomic>
 #include <algorithm>
 
 #include <daisysp.h>
 
+#include "HalfBand.h"
+
 
 namespace ID {
 #define PARAMETER_ID(str) constexpr const char* str { #str };
@@ -18,6 +19,7 @@ PARAMETER_ID (feedback)
 PARAMETER_ID (lpfreq)
 PARAMETER_ID (mix)
 PARAMETER_ID (freeze)
+PARAMETER_ID (quality)
 
 #undef PARAMETER_ID
 }
@@ -31,7 +33,7 @@ public:
     const String getName() const override { return JucePlugin_Name; }
 
     void prepareToPlay(double newSampleRate, int estimatedSamplesPerBlock) override;
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -44,13 +46,14 @@ public:
         Parameter &lpfreq;
         Parameter &mix;
         Parameter &freeze;
+        Parameter &quality;
     } params_;
 
     void getRMS(float &lIn, float &rIn, float &lOut, float &rOut) {
-        lIn = inRms_[0].lvl();
-        rIn = inRms_[1].lvl();
-        lOut = outRms_[0].lvl();
-        rOut = outRms_[1].lvl();
+        lIn = inputLevel(I_LEFT).peak;
+        rIn = inputLevel(I_RIGHT).peak;
+        lOut = outputLevel(O_LEFT).peak;
+        rOut = outputLevel(O_RIGHT).peak;
     }
 
     static BusesProperties getBusesProperties() {
@@ -91,9 +94,34 @@ private:
     static const String getInputBusName(int channelIndex);
     static const String getOutputBusName(int channelIndex);
 
+    enum Quality {
+        Q_FULL,
+        Q_HALF,
+        Q_MAX
+    };
+
+    void initReverb(Quality q);
+    void processFull(const float *inL, const float *inR, float *wetL, float *wetR, unsigned sz);
+    void processHalf(const float *inL, const float *inR, float *wetL, float *wetR, unsigned sz);
+
     daisysp::ReverbSc reverbSc_;
-    ssp::RmsTrack inRms_[2];
-    ssp::RmsTrack outRms_[2];
+    Quality quality_ = Q_FULL;
+
+    // half rate, reverb runs on every second sample, output is a sample behind
+    HalfBandDecimator decimator_[2];
+    HalfBandInterpolator interpolator_[2];
+    bool halfPhase_ = false;
+    float halfIn_[2] = {0.0f, 0.0f};
+    float halfOut_[2] = {0.0f, 0.0f};
+
+    // tail aware bypass, reverb stops once input and tail have been silent for TAIL_HOLD
+    static constexpr float SILENCE = 1e-5f; // -100dB
+    static constexpr float TAIL_HOLD = 0.25f; // seconds
+    unsigned silentSamples_ = 0;
+    bool idle_ = false;
+    bool muted_ = false; // mix was 0 last block, reverb not run
+
+    AudioSampleBuffer workBuf_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };
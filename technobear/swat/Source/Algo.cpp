@@ -24,7 +24,13 @@ double Algo::sampleRate_ = 48000.0f;
 
 
 void Algo::paint(Graphics &g) {
-    drawHelp(g);
+    if (!help_.isValid()) {
+        help_ = Image(Image::ARGB, 1600 - HELP_X, 480, true);
+        Graphics hg(help_);
+        hg.setOrigin(-HELP_X, 0);
+        drawHelp(hg);
+    }
+    g.drawImageAt(help_, HELP_X, 0);
 }
 
 void Algo::encoder(unsigned enc, int dir) {
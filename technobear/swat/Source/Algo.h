@@ -95,6 +95,11 @@ public:
 
     std::vector<std::shared_ptr<AlgoParam>> params_;
     static double sampleRate_;
+
+private:
+    // help is static, so pre-rendered (area right of HELP_X)
+    static constexpr int HELP_X = 900;
+    Image help_;
 };
 
 // simple helper
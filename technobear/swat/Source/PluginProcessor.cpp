@@ -136,7 +136,7 @@ void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     outBufs_.setSize(2 * MAX_ENG, samplesPerBlock);
 }
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned n = buffer.getNumSamples();
 
     for (auto e = 0; e < MAX_ENG; e++) {
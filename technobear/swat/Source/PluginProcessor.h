@@ -21,7 +21,7 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -72,6 +72,9 @@ public:
 protected:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // own state format, which replaces algorithms, so loaded synchronously
+    bool asyncStateLoad() override { return false; }
+
 private:
     enum {
         I_X_1,
@@ -15,7 +15,7 @@ void AgDelay::process(
 
     size_ = params_[0]->floatVal();
 
-    unsigned dlSz = getSampleRate() * (size_ / 1000.0f);
+    unsigned dlSz = std::min(unsigned(getSampleRate() * (size_ / 1000.0f)), delayLineCap_);
 
     if (delayLineSz_ != dlSz) {
 
@@ -28,8 +28,6 @@ void AgDelay::process(
         }
 
         delayLineSz_ = dlSz;
-        delete[] delayLine_;
-        delayLine_ = new float[delayLineSz_];
         memset(delayLine_, 0, sizeof(float) * delayLineSz_);
         writePos_ = 0;
     }
@@ -140,7 +138,7 @@ void AgSDelay::process(
 
     size_ = params_[0]->floatVal();
 
-    unsigned dlSz = size_;
+    unsigned dlSz = std::min(unsigned(size_), MAX_SIZE);
 
     if (delayLineSz_ != dlSz) {
 
@@ -152,8 +150,6 @@ void AgSDelay::process(
         }
 
         delayLineSz_ = dlSz;
-        delete[] delayLine_;
-        delayLine_ = new float[delayLineSz_];
         memset(delayLine_, 0, sizeof(float) * delayLineSz_);
         writePos_ = 0;
     }
@@ -17,13 +17,19 @@ public:
             params_[1]->floatVal(delayTime_);
         }
 
-        delayLineSz_ = getSampleRate() * (size_ / 1000.0f);
-        delayLine_ = new float[delayLineSz_];
-        memset(delayLine_, 0, sizeof(float) * delayLineSz_);
+        // allocated for the largest size, a size change (on the audio thread) only clears it
+        delayLineCap_ = unsigned(MAX_SAMPLE_RATE * (MAX_SIZE / 1000.0f));
+        delayLineSz_ = std::min(unsigned(getSampleRate() * (size_ / 1000.0f)), delayLineCap_);
+        delayLine_ = new float[delayLineCap_];
+        memset(delayLine_, 0, sizeof(float) * delayLineCap_);
         writePos_ = 0;
         smpDelay_ = 0;
     }
 
+    ~AgDelay() override {
+        delete[] delayLine_;
+    }
+
     unsigned type() override { return A_DELAY; }
 
     std::string name() override { return "Delay (Time)"; }
@@ -41,10 +47,14 @@ public:
     void paint(Graphics &g) override;
 
 private:
+    static constexpr float MAX_SIZE = 5000.0f; // mSec
+    static constexpr double MAX_SAMPLE_RATE = 96000.0;
+
     std::atomic<float> size_;
     std::atomic<float> delayTime_;
 
     float *delayLine_;
+    unsigned delayLineCap_;
     unsigned delayLineSz_;
     unsigned writePos_;
 
@@ -65,13 +75,18 @@ public:
             params_[1]->floatVal(delayTime_);
         }
 
-        delayLineSz_ = size_;
-        delayLine_ = new float[delayLineSz_];
-        memset(delayLine_, 0, sizeof(float) * delayLineSz_);
+        // allocated for the largest size, a size change (on the audio thread) only clears it
+        delayLineSz_ = std::min(unsigned(size_), MAX_SIZE);
+        delayLine_ = new float[MAX_SIZE];
+        memset(delayLine_, 0, sizeof(float) * MAX_SIZE);
         writePos_ = 0;
         smpDelay_ = 0;
     }
 
+    ~AgSDelay() override {
+        delete[] delayLine_;
+    }
+
     unsigned type() override { return A_S_DELAY; }
 
     std::string name() override { return "Delay (Sample)"; }
@@ -89,6 +104,8 @@ public:
     void paint(Graphics &g) override;
 
 private:
+    static constexpr unsigned MAX_SIZE = 4096; // smps
+
     std::atomic<float> size_;
     std::atomic<float> delayTime_;
 
@@ -22,9 +22,9 @@ PluginEditor::PluginEditor(PluginProcessor &p)
 
     addParamPage(
         std::make_shared<pcontrol_type>(processor_.params_.select, 1.0f, 0.01),
-        nullptr,
-        nullptr,
-        nullptr,
+        std::make_shared<pcontrol_type>(processor_.params_.slewtime, 10.0f, 0.1f),
+        std::make_shared<pcontrol_type>(processor_.params_.snapslot, 1.0f, 1.0f),
+        std::make_shared<pcontrol_type>(processor_.params_.snapxfade, 100.0f, 10.0f),
         view,
         Colours::orange
     );
@@ -34,8 +34,8 @@ PluginEditor::PluginEditor(PluginProcessor &p)
         std::make_shared<bcontrol_type>(processor_.params_.morph, 24, Colours::orange),
         nullptr,
         nullptr,
-        nullptr,
-        nullptr,
+        std::make_shared<bcontrol_type>(processor_.params_.snapstore, 24, Colours::orange, Colours::black, false),
+        std::make_shared<bcontrol_type>(processor_.params_.snaprecall, 24, Colours::orange, Colours::black, false),
         nullptr,
         nullptr,
         view
@@ -12,8 +12,10 @@ PluginProcessor::PluginProcessor()
 PluginProcessor::PluginProcessor(
     const AudioProcessor::BusesProperties &ioLayouts,
     AudioProcessorValueTreeState::ParameterLayout layout)
-    : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()) {
+    : BaseProcessor(ioLayouts, std::move(layout)), params_(vts()),
+      snapshots_(snapshotParams(), params_.snapslot, params_.snapxfade) {
     init();
+    updateLayerMatrix();
     float select = 0.0f;
     for (int i = 0; i < MAX_SIG_OUT; i++) {
         lastVolt_[i] = getCurrentVolt(select, i, params_.morph.getValue() > 0.5f);
@@ -51,7 +53,12 @@ PluginProcessor::Layer::Layer(AudioProcessorValueTreeState &, unsigned id) :
 PluginProcessor::PluginParams::PluginParams(AudioProcessorValueTreeState &apvt) :
     slew(*apvt.getParameter(ID::slew)),
     select(*apvt.getParameter(ID::select)),
-    morph(*apvt.getParameter(ID::morph)) {
+    morph(*apvt.getParameter(ID::morph)),
+    slewtime(*apvt.getParameter(ID::slewtime)),
+    snapslot(*apvt.getParameter(ID::snapslot)),
+    snapstore(*apvt.getParameter(ID::snapstore)),
+    snaprecall(*apvt.getParameter(ID::snaprecall)),
+    snapxfade(*apvt.getParameter(ID::snapxfade)) {
     for (unsigned lid = 0; lid < MAX_LAYERS; lid++) {
         auto layer = std::make_unique<Layer>(apvt, lid);
         for (unsigned vid = 0; vid < MAX_SIG_IN; vid++) {
@@ -91,6 +98,14 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
     }
     params.add(std::move(layers));
 
+    // added after layers, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::slewtime, "Slew ms", 0.0f, 1000.0f, 2.5f));
+
+    // added after slew time, to keep parameter indexes (used by midi automation) stable
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::snapslot, "Snap", 1.0f, float(MAX_SNAPSHOTS), 1.0f, 1.0f));
+    params.add(std::make_unique<ssp::BaseBoolParameter>(ID::snapstore, "Store", false));
+    params.add(std::make_unique<ssp::BaseBoolParameter>(ID::snaprecall, "Recall", false));
+    params.add(std::make_unique<ssp::BaseFloatParameter>(ID::snapxfade, "XFade ms", 0.0f, 5000.0f, 0.0f));
 
     return params;
 }
@@ -114,7 +129,9 @@ const String PluginProcessor::getInputBusName(int channelIndex) {
         "In M",
         "In N",
         "In O",
-        "In P"
+        "In P",
+        "Snap",
+        "Snap Trig"
     };
     if (channelIndex < I_MAX) { return inBusName[channelIndex]; }
     return "ZZIn-" + String(channelIndex);
@@ -147,66 +164,185 @@ const String PluginProcessor::getOutputBusName(int channelIndex) {
 
 void PluginProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPerBlock) {
     BaseProcessor::prepareToPlay(newSampleRate, estimatedSamplesPerBlock);
+    updateLayerMatrix();
     for (int i = 0; i < MAX_SIG_OUT; i++) {
-        float select = (params_.select.getValue() * MAX_LAYERS);
+        float select = (params_.select.getValue() * (MAX_LAYERS - 1));
         lastVolt_[i] = getCurrentVolt(select, i, params_.morph.getValue() > 0.5f);
     }
 }
 
 
+void PluginProcessor::audioProcessorParameterChanged(AudioProcessor *p, int parameterIndex, float newValue) {
+    BaseProcessor::audioProcessorParameterChanged(p, parameterIndex, newValue);
+    matrixDirty_ = true;
+    if (newValue < 0.5f) return;
+    if (parameterIndex == params_.snapstore.getParameterIndex()) {
+        snapshots_.requestStore();
+    } else if (parameterIndex == params_.snaprecall.getParameterIndex()) {
+        snapshots_.requestRecall();
+    }
+}
+
+
+void PluginProcessor::updateLayerMatrix() {
+    matrixDirty_ = false;
+    for (unsigned l = 0; l < MAX_LAYERS; l++) {
+        auto &layer = params_.layers_[l];
+        for (unsigned v = 0; v < MAX_SIG_OUT; v++) {
+            snapValues_[(l * MAX_SIG_OUT) + v] = layer->volts_[v]->val.getValue();
+        }
+    }
+    layerMatrixFrom(snapValues_);
+}
+
+
+void PluginProcessor::layerMatrixFrom(const float *values) {
+    for (unsigned l = 0; l < MAX_LAYERS; l++) {
+        for (unsigned v = 0; v < MAX_SIG_OUT; v++) {
+            layerMatrix_[l][v] = (values[(l * MAX_SIG_OUT) + v] * 2.0f) - 1.0f;
+        }
+    }
+}
+
+
 float PluginProcessor::getCurrentVolt(float layer, unsigned volt, bool morph) {
     float vout = 0.0f;
     if (morph) {
-        float l1 = std::min(floorf(layer), float(MAX_LAYERS) - 1.0f);
-        float l2 = std::min(l1 + 1.0f, float(MAX_LAYERS) - 1.0f);
-
-        float m = layer - l1;
-        auto &layer1 = params_.layers_[l1];
-        auto &layer2 = params_.layers_[l2];
-
-        float l1v = ((layer1->volts_[volt]->val.getValue() * 2.0f) - 1.0f) * (1.0f - m);
-        float l2v = ((layer2->volts_[volt]->val.getValue() * 2.0f) - 1.0f) * m;
-        vout = l1v + l2v;
+        unsigned l1 = std::min(unsigned(layer), MAX_LAYERS - 1);
+        unsigned l2 = std::min(l1 + 1, MAX_LAYERS - 1);
+        float m = layer - float(l1);
+        vout = (layerMatrix_[l1][volt] * (1.0f - m)) + (layerMatrix_[l2][volt] * m);
     } else {
         // take nearest layer
-        unsigned l1 = floorf(layer + 0.5f);
-        l1 = std::max(std::min(l1, MAX_LAYERS - 1), unsigned(0));
-        assert(l1 < params_.layers_.size());
-        auto &layer1 = params_.layers_[l1];
-        vout = ((layer1->volts_[volt]->val.getValue() * 2.0f) - 1.0f);
+        unsigned l1 = std::min(unsigned(layer + 0.5f), MAX_LAYERS - 1);
+        vout = layerMatrix_[l1][volt];
     }
 
     return vout;
 }
 
 
-void PluginProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
+void PluginProcessor::processAudio(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
     unsigned sz = buffer.getNumSamples();
     bool morph = params_.morph.getValue() > 0.5f;
     bool slew = params_.slew.getValue() > 0.5f;
 
-    float selectOffset = buffer.getSample(I_SELECT,0);
-    float select = std::min(std::max(((params_.select.getValue() + selectOffset ) * float(MAX_LAYERS - 1)), 0.0f), float(MAX_LAYERS - 1));
-
-    for (int i = 0; i < O_MAX; i++) {
-        if (!isOutputEnabled(O_SIG_A + i)) continue;
+    const float *snapCV = isInputEnabled(I_SNAP) ? buffer.getReadPointer(I_SNAP) : nullptr;
+    const float *snapTrig = isInputEnabled(I_SNAP_TRIG) ? buffer.getReadPointer(I_SNAP_TRIG) : nullptr;
+    if (snapshots_.process(snapCV, snapTrig, sz, getSampleRate(), snapValues_)) {
+        layerMatrixFrom(snapValues_);
+        // back to parameters once recall completes
+        matrixDirty_ = true;
+    } else if (matrixDirty_) {
+        updateLayerMatrix();
+    }
 
-        bool in = isInputEnabled(I_SIG_A + i);
+    // one pole slew, time constant in ms
+    float slewMs = params_.slewtime.convertFrom0to1(params_.slewtime.getValue());
+    float slewRate = 1.0f;
+    if (slew && slewMs > 0.0f) {
+        slewRate = 1.0f - expf(-1000.0f / (slewMs * float(getSampleRate())));
+    }
+    const ssp::float4 vSlew = ssp::float4::dup(slewRate);
+
+    static constexpr float maxLayer = float(MAX_LAYERS - 1);
+    const float selectParam = params_.select.getValue();
+    const float *selectIn = buffer.getReadPointer(I_SELECT);
+    const bool selectCV = isInputEnabled(I_SELECT);
+
+    const float *in[MAX_SIG_IN];
+    float *out[MAX_SIG_OUT];
+    bool inEnabled[MAX_SIG_IN];
+    bool outEnabled[MAX_SIG_OUT];
+    bool anyOut = false;
+    for (unsigned i = 0; i < MAX_SIG_OUT; i++) {
+        in[i] = buffer.getReadPointer(I_SIG_A + i);
+        out[i] = buffer.getWritePointer(O_SIG_A + i);
+        inEnabled[i] = isInputEnabled(I_SIG_A + i);
+        outEnabled[i] = isOutputEnabled(O_SIG_A + i);
+        anyOut |= outEnabled[i];
+    }
+    if (!anyOut) return;
 
-        float attnP = getCurrentVolt(select, i, morph);
+    ssp::float4 last[N_GROUPS];
+    ssp::float4 target[N_GROUPS];
+    for (unsigned g = 0; g < N_GROUPS; g++) {
+        last[g] = ssp::float4::load(lastVolt_ + g * ssp::float4::N);
+    }
 
-        for (int smp = 0; smp < sz; smp++) {
-            auto &lP = lastVolt_[i];
-            float sigv = in ? buffer.getSample(I_SIG_A + i, smp) : 1.0f; // normalise to 1
-            float attn = attnP;
-            if (slew) {
-                static constexpr float slewRate = (1.0f / 128.0f);
-                attn = lP + ((attnP - lP) * slewRate);
+    float lastSelect = -1.0f;
+    for (unsigned smp = 0; smp < sz; smp++) {
+        // note: select shares its channel with out A, and each input with the next output
+        // so all inputs for this sample are read before any output is written
+        float selectOffset = selectCV ? selectIn[smp] : 0.0f;
+        float select = std::min(std::max(((selectParam + selectOffset) * maxLayer), 0.0f), maxLayer);
+
+        if (select != lastSelect) {
+            lastSelect = select;
+            unsigned l1, l2;
+            float m;
+            if (morph) {
+                l1 = std::min(unsigned(select), MAX_LAYERS - 1);
+                l2 = std::min(l1 + 1, MAX_LAYERS - 1);
+                m = select - float(l1);
+            } else {
+                // take nearest layer
+                l1 = l2 = std::min(unsigned(select + 0.5f), MAX_LAYERS - 1);
+                m = 0.0f;
+            }
+            const ssp::float4 vm = ssp::float4::dup(m);
+            for (unsigned g = 0; g < N_GROUPS; g++) {
+                unsigned o = g * ssp::float4::N;
+                ssp::float4 a = ssp::float4::load(layerMatrix_[l1] + o);
+                ssp::float4 b = ssp::float4::load(layerMatrix_[l2] + o);
+                target[g] = ssp::float4::madd(a, b - a, vm);
             }
-            buffer.setSample(O_SIG_A + i, smp, sigv * attn);
-            lP = attn;
+        }
+
+        alignas(16) float sig[MAX_SIG_OUT];
+        for (unsigned i = 0; i < MAX_SIG_OUT; i++) {
+            sig[i] = inEnabled[i] ? in[i][smp] : 1.0f; // normalise to 1
+        }
+
+        alignas(16) float res[MAX_SIG_OUT];
+        for (unsigned g = 0; g < N_GROUPS; g++) {
+            unsigned o = g * ssp::float4::N;
+            last[g] = ssp::float4::madd(last[g], target[g] - last[g], vSlew);
+            (ssp::float4::load(sig + o) * last[g]).store(res + o);
+        }
+
+        for (unsigned i = 0; i < MAX_SIG_OUT; i++) {
+            if (outEnabled[i]) out[i][smp] = res[i];
         }
     }
+
+    for (unsigned g = 0; g < N_GROUPS; g++) {
+        last[g].store(lastVolt_ + g * ssp::float4::N);
+    }
+}
+
+
+std::vector<juce::RangedAudioParameter *> PluginProcessor::snapshotParams() {
+    std::vector<juce::RangedAudioParameter *> values;
+    for (unsigned l = 0; l < MAX_LAYERS; l++) {
+        auto &layer = params_.layers_[l];
+        for (unsigned v = 0; v < MAX_SIG_OUT; v++) {
+            values.push_back(&layer->volts_[v]->val);
+        }
+    }
+    return values;
+}
+
+
+void PluginProcessor::customToXml(juce::XmlElement *xml) {
+    BaseProcessor::customToXml(xml);
+    snapshots_.toXml(xml);
+}
+
+
+void PluginProcessor::customFromXml(juce::XmlElement *xml) {
+    BaseProcessor::customFromXml(xml);
+    snapshots_.fromXml(xml);
 }
 
 
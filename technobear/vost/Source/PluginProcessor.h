@@ -3,10 +3,13 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "ssp/BaseProcessor.h"
+#include "ssp/SnapshotBank.h"
 
 #include <atomic>
 #include <algorithm>
 
+#include "ssp/Float4.h"
+
 
 namespace ID {
 #define PARAMETER_ID(str) constexpr const char* str { #str };
@@ -23,6 +26,13 @@ PARAMETER_ID (layers)
 PARAMETER_ID (volts)
 PARAMETER_ID (val)
 
+PARAMETER_ID (slewtime)
+
+PARAMETER_ID (snapslot)
+PARAMETER_ID (snapstore)
+PARAMETER_ID (snaprecall)
+PARAMETER_ID (snapxfade)
+
 #undef PARAMETER_ID
 }
 
@@ -35,7 +45,7 @@ public:
 
     const String getName() const override { return JucePlugin_Name; }
 
-    void processBlock(AudioSampleBuffer &, MidiBuffer &) override;
+    void processAudio(AudioSampleBuffer &, MidiBuffer &) override;
 
     AudioProcessorEditor *createEditor() override;
 
@@ -61,6 +71,8 @@ public:
         I_SIG_N,
         I_SIG_O,
         I_SIG_P,
+        I_SNAP,
+        I_SNAP_TRIG,
         I_MAX
     };
     enum {
@@ -87,6 +99,7 @@ public:
     static constexpr unsigned MAX_SIG_OUT = (O_SIG_P - O_SIG_A) + 1;
 
     static constexpr unsigned MAX_LAYERS = 10;
+    static constexpr unsigned MAX_SNAPSHOTS = 16;
 
     struct VoltParam {
         using Parameter = juce::RangedAudioParameter;
@@ -114,6 +127,13 @@ public:
         Parameter &morph;
 
         std::vector<std::unique_ptr<Layer>> layers_;
+
+        Parameter &slewtime;
+
+        Parameter &snapslot;
+        Parameter &snapstore;
+        Parameter &snaprecall;
+        Parameter &snapxfade;
     } params_;
 
     Layer &getLayer(unsigned layer) {
@@ -138,6 +158,10 @@ protected:
 
     float getCurrentVolt(float layer, unsigned volt,bool morph);
 
+    void audioProcessorParameterChanged(AudioProcessor *p, int parameterIndex, float newValue) override;
+    void customFromXml(juce::XmlElement *) override;
+    void customToXml(juce::XmlElement *) override;
+
 private:
     bool isBusesLayoutSupported(const BusesLayout &layouts) const override {
         return true;
@@ -145,7 +169,21 @@ private:
     static const String getInputBusName(int channelIndex);
     static const String getOutputBusName(int channelIndex);
 
-    float lastVolt_[MAX_SIG_OUT];
+    static constexpr unsigned N_GROUPS = MAX_SIG_OUT / ssp::float4::N;
+
+    // layer volts (-1..1), rebuilt on parameter change, rather than read from params each block
+    void updateLayerMatrix();
+    void layerMatrixFrom(const float *values);
+    alignas(16) float layerMatrix_[MAX_LAYERS][MAX_SIG_OUT];
+    std::atomic<bool> matrixDirty_{true};
+
+    // snapshots of all layer values
+    static constexpr unsigned N_SNAP_VALUES = MAX_LAYERS * MAX_SIG_OUT;
+    std::vector<juce::RangedAudioParameter *> snapshotParams();
+    ssp::Snapshots<N_SNAP_VALUES, MAX_SNAPSHOTS> snapshots_;
+    float snapValues_[N_SNAP_VALUES]; // values in use
+
+    alignas(16) float lastVolt_[MAX_SIG_OUT];
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };